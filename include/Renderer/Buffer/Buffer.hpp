@@ -13,6 +13,10 @@ class Buffer {
         VmaAllocation allocation = {};
         vk::BufferUsageFlags usage = {};
 
+        BufferMemory memory = BufferMemory::GPU_ONLY;
+        void* mapped = nullptr;         // Persistently mapped when the memory it got is host visible
+        bool hostCoherent = false;
+
     public:
         size_t size = 0;
 
@@ -29,6 +33,11 @@ class Buffer {
 
     public:
         std::string getName() const { return name; }
+        VkBuffer getHandle() const { return buffer; }
+        BufferMemory getMemory() const { return memory; }
+
+        // Written in place by Renderer::WriteBuffer(), without a staging copy
+        bool isMapped() const { return mapped != nullptr; }
 
         bool operator==(const Buffer& other) const {
             return name == other.name;
@@ -50,6 +59,12 @@ class UniformBuffer : public Buffer {
         UniformBuffer(const std::string& name, size_t size) : Buffer(name, size, BufferUsage::UNIFORM_BUFFER) {}
 };
 
+class StorageBuffer : public Buffer {
+    public:
+        StorageBuffer(const std::string& name) : Buffer(name, BufferUsage::STORAGE_BUFFER) {}
+        StorageBuffer(const std::string& name, size_t size) : Buffer(name, size, BufferUsage::STORAGE_BUFFER) {}
+};
+
 class TransferBuffer : public Buffer {
     public:
         TransferBuffer(const std::string& name) : Buffer(name, BufferUsage::TRANSFER_BUFFER) {}
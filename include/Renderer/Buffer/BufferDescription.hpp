@@ -3,11 +3,21 @@
 enum class BufferUsage {
     VERTEX_BUFFER,
     TRANSFER_BUFFER,
-    UNIFORM_BUFFER
+    UNIFORM_BUFFER,
+    STORAGE_BUFFER
+};
+
+// Where a buffer lives and how the host reaches it, see Renderer::WriteBuffer()
+enum class BufferMemory {
+    GPU_ONLY,                   // Device local, written through staging copies
+    UPLOAD_SEQUENTIAL_WRITE,    // Host visible and mapped, written sequentially by the CPU (staging, streamed data)
+    READBACK,                   // Host visible, cached and mapped, written by the GPU and read by the CPU
+    DEVICE_LOCAL_HOST_VISIBLE   // Device local and mapped where the device allows it (ReBAR, UMA), staged otherwise
 };
 
 struct BufferDescription {
     std::string name = "";
     size_t size = {};
     BufferUsage usage = {};
+    BufferMemory memory = BufferMemory::GPU_ONLY;
 };
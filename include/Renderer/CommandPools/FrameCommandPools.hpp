@@ -0,0 +1,94 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+
+// Command buffers of one frame in flight. Each recording thread allocates from its own transient
+// pool (pools are externally synchronized), and every pool is reset at once with resetCommandPool
+// when the frame's fence has signaled. Any number of primaries and secondaries can be handed out
+// per frame, they are reused by the following frames on the same slot.
+class FrameCommandPools {
+    private:
+        struct ThreadPool {
+            vk::raii::CommandPool pool = nullptr;
+
+            // Deques: handed out references stay valid as more buffers are allocated
+            std::deque<vk::raii::CommandBuffer> primaries;
+            std::deque<vk::raii::CommandBuffer> secondaries;
+            size_t usedPrimaries = 0u;
+            size_t usedSecondaries = 0u;
+        };
+
+        const vk::raii::Device* m_device = nullptr;
+        uint32_t m_queueFamilyIndex = 0u;
+
+        std::mutex m_mutex;     // Guards m_threadPools, not the pools themselves
+        std::unordered_map<std::thread::id, std::unique_ptr<ThreadPool>> m_threadPools;
+
+    public:
+        FrameCommandPools(const vk::raii::Device& device, uint32_t queueFamilyIndex)
+            : m_device(&device), m_queueFamilyIndex(queueFamilyIndex) {}
+
+        FrameCommandPools(const FrameCommandPools&) = delete;
+        FrameCommandPools& operator=(const FrameCommandPools&) = delete;
+
+    public:
+        // Valid until the next Reset(), only to be recorded by the calling thread
+        const vk::raii::CommandBuffer& AllocatePrimary() {
+            ThreadPool& threadPool = getThreadPool();
+            return Allocate(threadPool, threadPool.primaries, threadPool.usedPrimaries, vk::CommandBufferLevel::ePrimary);
+        }
+
+        const vk::raii::CommandBuffer& AllocateSecondary() {
+            ThreadPool& threadPool = getThreadPool();
+            return Allocate(threadPool, threadPool.secondaries, threadPool.usedSecondaries, vk::CommandBufferLevel::eSecondary);
+        }
+
+        // Once the frame's fence has signaled and no thread is recording from these pools
+        void Reset() {
+            std::scoped_lock lock(m_mutex);
+
+            for (auto& [thread, threadPool] : m_threadPools) {
+                if (threadPool->usedPrimaries == 0u && threadPool->usedSecondaries == 0u) continue;
+
+                threadPool->pool.reset();
+                threadPool->usedPrimaries = 0u;
+                threadPool->usedSecondaries = 0u;
+            }
+        }
+
+    private:
+        ThreadPool& getThreadPool() {
+            std::scoped_lock lock(m_mutex);
+
+            std::unique_ptr<ThreadPool>& threadPool = m_threadPools[std::this_thread::get_id()];
+            if (!threadPool) {
+                threadPool = std::make_unique<ThreadPool>();
+                threadPool->pool = vk::raii::CommandPool(*m_device,
+                        vk::CommandPoolCreateInfo {
+                            .flags = vk::CommandPoolCreateFlagBits::eTransient,
+                            .queueFamilyIndex = m_queueFamilyIndex
+                        });
+            }
+
+            return *threadPool;
+        }
+
+        const vk::raii::CommandBuffer& Allocate(ThreadPool& threadPool, std::deque<vk::raii::CommandBuffer>& buffers,
+                size_t& used, vk::CommandBufferLevel level) {
+            if (used == buffers.size()) {
+                vk::raii::CommandBuffers allocated(*m_device,
+                        vk::CommandBufferAllocateInfo {
+                            .commandPool = threadPool.pool,
+                            .level = level,
+                            .commandBufferCount = 1u
+                        });
+                buffers.push_back(std::move(allocated.front()));
+            }
+
+            return buffers[used++];
+        }
+};
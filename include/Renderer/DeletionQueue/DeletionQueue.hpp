@@ -0,0 +1,74 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+// Defers destruction of GPU objects until the frame that last used them has completed
+class DeletionQueue {
+    public:
+        using FrameNumber = uint64_t;
+        using Deleter = std::move_only_function<void()>;
+
+    private:
+        // Everything retired during the same frame is freed together
+        struct Bucket {
+            FrameNumber frame = 0u;
+            std::vector<Deleter> deleters;
+        };
+
+        // Ordered by frame: entries are always pushed with the current (monotonic) frame number
+        std::deque<Bucket> m_buckets;
+
+    public:
+        void Push(FrameNumber frame, Deleter&& deleter) {
+            if (m_buckets.empty() || m_buckets.back().frame != frame) {
+                m_buckets.emplace_back(Bucket{ .frame = frame });
+            }
+
+            m_buckets.back().deleters.emplace_back(std::move(deleter));
+        }
+
+        // Keeps a RAII object (or container of them) alive until `frame` has completed
+        template<typename T>
+        requires (!std::is_lvalue_reference_v<T>)
+        void Retire(FrameNumber frame, T&& object) {
+            Push(frame, [held = std::move(object)] () mutable {
+                        [[maybe_unused]] T released = std::move(held);
+                    });
+        }
+
+        // Frees every bucket whose frame is <= completedFrame
+        void Flush(FrameNumber completedFrame) {
+            while (!m_buckets.empty() && m_buckets.front().frame <= completedFrame) {
+                FlushBucket(m_buckets.front());
+                m_buckets.pop_front();
+            }
+        }
+
+        // Only safe once the device is idle
+        void FlushAll() {
+            while (!m_buckets.empty()) {
+                FlushBucket(m_buckets.front());
+                m_buckets.pop_front();
+            }
+        }
+
+        bool empty() const { return m_buckets.empty(); }
+
+        size_t size() const {
+            size_t count = 0u;
+            for (const Bucket& bucket : m_buckets) count += bucket.deleters.size();
+            return count;
+        }
+
+    private:
+        static void FlushBucket(Bucket& bucket) {
+            for (Deleter& deleter : bucket.deleters) {
+                deleter();
+            }
+            bucket.deleters.clear();
+        }
+};
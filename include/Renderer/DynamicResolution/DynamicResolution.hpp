@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+
+// Picks the render scale of dynamic swapchain-relative images from measured GPU frame time.
+// Cost is assumed proportional to the pixel count (scale^2): the scale moves by the square root
+// of the budget ratio, smoothed and with a dead zone so it does not oscillate around the target.
+class DynamicResolution {
+    public:
+        struct Settings {
+            double targetFrameTimeMs = 16.6;
+            float minScale = 0.5f;
+            float maxScale = 1.0f;
+            double smoothing = 0.1;         // Weight of the newest sample in the moving average
+            float deadZone = 0.05f;         // Ignore scale changes smaller than this fraction
+        };
+
+    private:
+        Settings m_settings {};
+        float m_scale = 1.0f;
+        double m_averageFrameTimeMs = 0.0;
+
+    public:
+        DynamicResolution() = default;
+        DynamicResolution(const Settings& settings)
+            : m_settings(settings), m_scale(settings.maxScale), m_averageFrameTimeMs(settings.targetFrameTimeMs) {}
+
+    public:
+        // Returns the scale to render the next frames at
+        float Update(double gpuFrameTimeMs) {
+            m_averageFrameTimeMs += (gpuFrameTimeMs - m_averageFrameTimeMs) * m_settings.smoothing;
+            if (m_averageFrameTimeMs <= 0.0) return m_scale;
+
+            const float ideal = std::clamp(
+                    m_scale * static_cast<float>(std::sqrt(m_settings.targetFrameTimeMs / m_averageFrameTimeMs)),
+                    m_settings.minScale, m_settings.maxScale);
+
+            const bool atLimit = ideal == m_settings.minScale || ideal == m_settings.maxScale;
+            if (std::abs(ideal - m_scale) > m_scale * m_settings.deadZone || (atLimit && ideal != m_scale)) {
+                m_scale = ideal;
+            }
+
+            return m_scale;
+        }
+
+        float getScale() const { return m_scale; }
+        double getAverageFrameTimeMs() const { return m_averageFrameTimeMs; }
+        const Settings& getSettings() const { return m_settings; }
+};
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <chrono>
+#include <utility>
+#include <cstdint>
+#include <condition_variable>
+
+// Triple buffer between one producer and one consumer. The producer always has a slot to write,
+// the consumer always reads the newest published one: neither waits for the other, snapshots the
+// consumer was too slow for are dropped.
+template<typename T>
+class FrameMailbox {
+    private:
+        std::array<T, 3> m_slots {};
+
+        std::mutex m_mutex;
+        std::condition_variable m_consumed;
+        uint32_t m_write = 0u;      // Producer only
+        uint32_t m_ready = 1u;      // Last published, guarded by m_mutex
+        uint32_t m_read = 2u;       // Consumer only
+        bool m_fresh = false;       // m_ready has not been taken yet
+        bool m_anyRead = false;     // Consumer only
+
+    public:
+        // Producer: holds an older snapshot, every field has to be written again
+        T& getWriteSlot() { return m_slots[m_write]; }
+
+        void Publish() {
+            std::scoped_lock lock(m_mutex);
+            std::swap(m_write, m_ready);
+            m_fresh = true;
+        }
+
+        // Producer: at most one snapshot ahead of the consumer. False on timeout.
+        bool WaitUntilConsumed(std::chrono::milliseconds timeout) {
+            std::unique_lock lock(m_mutex);
+            return m_consumed.wait_for(lock, timeout, [this] { return !m_fresh; });
+        }
+
+        // Consumer: newest snapshot, valid until the next call. nullptr until the first Publish.
+        // `fresh` is set when it was not returned by a previous call.
+        const T* AcquireLatest(bool* fresh = nullptr) {
+            {
+                std::scoped_lock lock(m_mutex);
+                if (fresh) *fresh = m_fresh;
+                if (m_fresh) {
+                    std::swap(m_read, m_ready);
+                    m_fresh = false;
+                    m_anyRead = true;
+                }
+            }
+            m_consumed.notify_all();
+
+            return m_anyRead ? &m_slots[m_read] : nullptr;
+        }
+};
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unordered_map>
+
+#include "Utils.hpp"
+
+struct Camera {
+    glm::mat4 view { 1.0f };
+    glm::mat4 projection { 1.0f };
+    glm::vec3 position { 0.0f };
+};
+
+// One draw of a pass pipeline, looked up by name in RenderPass::pipelines
+struct DrawItem {
+    std::string pipeline = "";
+    glm::mat4 transform { 1.0f };
+    uint32_t vertexCount = 0u;
+    uint32_t instanceCount = 1u;
+    uint32_t firstVertex = 0u;
+    uint32_t firstInstance = 0u;
+};
+
+// Everything the render thread needs from one simulation step, immutable once published.
+// Passes read it through Renderer::getFrameSnapshot() while recording.
+struct FrameSnapshot {
+    uint64_t simulationFrame = 0u;
+    double time = 0.0;              // Seconds
+
+    Camera camera {};
+    std::vector<DrawItem> draws {};
+
+    // Contents of uniform buffers, by buffer name: copied by the render thread once per snapshot,
+    // through a staging buffer ordered after the frames still in flight
+    std::unordered_map<std::string, ByteArray> uniforms {};
+};
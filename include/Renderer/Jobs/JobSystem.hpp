@@ -0,0 +1,108 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+// Tracks a group of jobs: incremented when one is submitted against it, decremented when it
+// finishes, thrown or not. Jobs submitted with it as a dependency start once it reaches zero.
+class JobCounter {
+    friend class JobSystem;
+    private:
+        std::atomic<uint32_t> m_value = 0u;
+
+        std::mutex m_mutex;
+        std::vector<std::move_only_function<void()>> m_continuations;  // Guarded by m_mutex
+        std::exception_ptr m_error;     // First job that threw, guarded by m_mutex
+
+    public:
+        JobCounter() = default;
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+    public:
+        bool isDone() const { return m_value.load(std::memory_order_acquire) == 0u; }
+        uint32_t getValue() const { return m_value.load(std::memory_order_acquire); }
+};
+
+// Work-stealing scheduler: one deque per worker, owners push and pop at the back, idle workers
+// steal from the front of the others. Threads that are not workers submit to a shared queue and
+// help with jobs while they Wait(). Jobs that must run on the main thread (GLFW) are queued
+// separately and run by PumpMainThread(). Long background jobs (pipeline compiles) go to a queue
+// only idle workers take from, so a thread waiting on frame work never picks one up.
+class JobSystem {
+    public:
+        using Job = std::move_only_function<void()>;
+
+    private:
+        struct Task {
+            Job job;
+            JobCounter* counter = nullptr;
+        };
+
+        struct TaskQueue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        // One per worker, the last one is shared by every other thread
+        std::vector<std::unique_ptr<TaskQueue>> m_queues;
+        std::atomic<uint32_t> m_queuedTasks = 0u;
+
+        std::mutex m_sleepMutex;
+        std::condition_variable_any m_wake;
+
+        TaskQueue m_backgroundQueue;
+        TaskQueue m_mainThreadQueue;
+        std::thread::id m_mainThread;
+
+        std::vector<std::jthread> m_workers;
+
+    public:
+        // One worker per core but one, left to the thread that creates the system (the main thread)
+        JobSystem();
+        explicit JobSystem(uint32_t workerCount);
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+    public:
+        // `counter`, if any, is incremented now and decremented once the job has run
+        void Submit(Job job, JobCounter* counter = nullptr);
+
+        // Starts once `dependency` reaches zero, right away if it already has
+        void Submit(Job job, JobCounter& dependency, JobCounter* counter);
+
+        // Run by workers once they have nothing else to do, never by Wait()
+        void SubmitBackground(Job job, JobCounter* counter = nullptr);
+
+        // Queued until the main thread calls PumpMainThread(), or waits
+        void SubmitMainThread(Job job, JobCounter* counter = nullptr);
+        void PumpMainThread();
+
+        // Runs queued jobs until `counter` reaches zero instead of blocking, then rethrows the first
+        // exception a job submitted against it threw. Jobs without a counter only have theirs printed.
+        void Wait(JobCounter& counter);
+
+        uint32_t getWorkerCount() const { return static_cast<uint32_t>(m_workers.size()); }
+        bool isMainThread() const { return std::this_thread::get_id() == m_mainThread; }
+
+    private:
+        void Push(Task&& task);
+        void Notify();
+        bool TryRun(uint32_t queueIndex);
+        bool TryRunBackground();
+        void Run(Task& task);
+        void Finish(JobCounter* counter);
+        void WorkerLoop(uint32_t index, std::stop_token stopToken);
+
+        uint32_t getQueueIndex() const;
+};
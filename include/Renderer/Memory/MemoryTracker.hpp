@@ -0,0 +1,124 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+
+#include <vma/vk_mem_alloc.h>
+
+// What an allocation is for, reported separately by Renderer::getMemoryStats()
+enum class MemoryCategory : uint8_t {
+    GRAPH_IMAGES,
+    GRAPH_BUFFERS,
+    VERTEX_BUFFERS,
+    UNIFORM_BUFFERS,
+    TRANSFER_BUFFERS,
+    STORAGE_BUFFERS,
+    COUNT
+};
+
+inline std::string to_string(MemoryCategory category) {
+    switch (category) {
+        case MemoryCategory::GRAPH_IMAGES: return "Graph images";
+        case MemoryCategory::GRAPH_BUFFERS: return "Graph buffers";
+        case MemoryCategory::VERTEX_BUFFERS: return "Vertex buffers";
+        case MemoryCategory::UNIFORM_BUFFERS: return "Uniform buffers";
+        case MemoryCategory::TRANSFER_BUFFERS: return "Transfer buffers";
+        case MemoryCategory::STORAGE_BUFFERS: return "Storage buffers";
+        case MemoryCategory::COUNT: break;
+    }
+
+    return "Unknown";
+}
+
+struct MemoryCategoryStats {
+    VkDeviceSize bytes = 0u;
+    uint32_t allocationCount = 0u;
+};
+
+// One memory heap as VMA sees it. With VK_EXT_memory_budget `usage` and `budget` come from the
+// driver and include other processes, otherwise they are estimated from this renderer's own blocks.
+struct MemoryHeapBudget {
+    uint32_t heapIndex = 0u;
+    bool deviceLocal = false;
+
+    VkDeviceSize usage = 0u;
+    VkDeviceSize budget = 0u;           // Capped by MemoryBudgetSettings::deviceLocalLimit
+
+    VkDeviceSize blockBytes = 0u;       // Device memory this renderer allocated
+    VkDeviceSize allocationBytes = 0u;  // Part of blockBytes handed out to resources
+    uint32_t blockCount = 0u;
+    uint32_t allocationCount = 0u;
+};
+
+struct MemoryStats {
+    bool driverBudget = false;          // VK_EXT_memory_budget is enabled
+    std::vector<MemoryHeapBudget> heaps;
+    std::array<MemoryCategoryStats, static_cast<size_t>(MemoryCategory::COUNT)> categories {};
+
+    const MemoryCategoryStats& get(MemoryCategory category) const { return categories[static_cast<size_t>(category)]; }
+};
+
+struct MemoryBudgetSettings {
+    // Reported once a heap's usage goes over this fraction of its budget, again only after it
+    // went back under
+    float warningRatio = 0.9f;
+
+    // This instance's share of VRAM: caps the budget of every device-local heap, 0 for none
+    VkDeviceSize deviceLocalLimit = 0u;
+
+    // Called on the thread running Render(), DEBUG_PRINTs a warning when empty
+    std::function<void(const MemoryHeapBudget&)> onNearBudget;
+};
+
+// Bytes and allocation counts per category. The category is stored in the allocation's user data
+// so the code freeing it does not have to know it. Counters are atomic: allocations are freed by
+// the render thread while stats are read by others.
+class MemoryTracker {
+    private:
+        std::array<std::atomic<VkDeviceSize>, static_cast<size_t>(MemoryCategory::COUNT)> m_bytes {};
+        std::array<std::atomic<uint32_t>, static_cast<size_t>(MemoryCategory::COUNT)> m_counts {};
+
+    public:
+        MemoryTracker() = default;
+        MemoryTracker(const MemoryTracker&) = delete;
+        MemoryTracker& operator=(const MemoryTracker&) = delete;
+
+    public:
+        void Track(VmaAllocator allocator, VmaAllocation allocation, MemoryCategory category) {
+            if (!allocation) return;
+
+            // Stored off by one: null user data is an untracked allocation
+            vmaSetAllocationUserData(allocator, allocation, reinterpret_cast<void*>(static_cast<uintptr_t>(category) + 1u));
+
+            VmaAllocationInfo info {};
+            vmaGetAllocationInfo(allocator, allocation, &info);
+
+            m_bytes[static_cast<size_t>(category)].fetch_add(info.size, std::memory_order_relaxed);
+            m_counts[static_cast<size_t>(category)].fetch_add(1u, std::memory_order_relaxed);
+        }
+
+        // Before the allocation is freed
+        void Untrack(VmaAllocator allocator, VmaAllocation allocation) {
+            if (!allocation) return;
+
+            VmaAllocationInfo info {};
+            vmaGetAllocationInfo(allocator, allocation, &info);
+
+            const uintptr_t tag = reinterpret_cast<uintptr_t>(info.pUserData);
+            if (tag == 0u || tag > static_cast<uintptr_t>(MemoryCategory::COUNT)) return;
+
+            m_bytes[tag - 1u].fetch_sub(info.size, std::memory_order_relaxed);
+            m_counts[tag - 1u].fetch_sub(1u, std::memory_order_relaxed);
+        }
+
+        MemoryCategoryStats get(MemoryCategory category) const {
+            return MemoryCategoryStats {
+                .bytes = m_bytes[static_cast<size_t>(category)].load(std::memory_order_relaxed),
+                .allocationCount = m_counts[static_cast<size_t>(category)].load(std::memory_order_relaxed)
+            };
+        }
+};
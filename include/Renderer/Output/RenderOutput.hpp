@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Renderer/DynamicResolution/DynamicResolution.hpp"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <optional>
+
+// Forward Declarations
+class GLFWwindow;
+namespace RenderGraph {
+    class RenderGraph;
+}
+
+// A window and everything needed to present to it. Each output runs its own graph, whose
+// "BackBuffer" resource is bound to the swapchain image acquired for the frame.
+struct RenderOutput {
+    GLFWwindow* window = nullptr;
+    vk::raii::SurfaceKHR surface = VK_NULL_HANDLE;
+
+    vk::raii::SwapchainKHR swapChain = VK_NULL_HANDLE;
+    std::vector<vk::Image> swapChainImages;
+    std::vector<vk::raii::ImageView> swapChainImageViews;
+
+    vk::Extent2D swapChainExtent = {};
+    vk::SurfaceFormatKHR surfaceFormat = {};
+    vk::ImageUsageFlags swapChainUsage = {};
+
+    // Recorded for the current frame, from the frame's transient pool
+    vk::CommandBuffer commandBuffer = nullptr;
+
+    // One per frame in flight
+    std::vector<vk::raii::Semaphore> presentCompleteSemaphores;
+
+    // One per swapchain image: a semaphore may still be pending on a previous present of the same image
+    std::vector<vk::raii::Semaphore> renderFinishedSemaphores;
+
+    // Replaced by a recreation. Frame fences do not cover presents, so these are kept until the
+    // current swapchain has presented each of its images: by then the presents still waiting on the
+    // old semaphores have been processed.
+    struct RetiredSwapChain {
+        vk::raii::SwapchainKHR swapChain = VK_NULL_HANDLE;
+        std::vector<vk::raii::ImageView> imageViews;
+        std::vector<vk::raii::Semaphore> renderFinishedSemaphores;
+    };
+    std::vector<RetiredSwapChain> retiredSwapChains;
+    std::vector<bool> imagesPresented;      // Per image of the current swapchain, since it was created
+
+    std::unique_ptr<RenderGraph::RenderGraph> renderGraph;
+
+    // Dynamic resolution: GPU time of each frame slot, measured with a pair of timestamps
+    std::optional<DynamicResolution> dynamicResolution;
+    vk::raii::QueryPool timestampPool = VK_NULL_HANDLE;
+    std::vector<bool> timestampsWritten;
+
+    // Written by GLFW callbacks on the main thread, read by whichever thread renders
+    std::atomic<vk::Extent2D> frameBufferSize = vk::Extent2D{};
+    std::atomic<bool> frameBufferResized = false;
+    std::atomic<bool> swapChainOutdated = false;  // Recreation was deferred (e.g. window minimized)
+    uint32_t imageIndex = 0u;        // Acquired for the frame being recorded
+};
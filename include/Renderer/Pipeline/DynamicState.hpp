@@ -0,0 +1,66 @@
+#pragma once
+
+#include <vector>
+#include <optional>
+
+// Which pipeline states are left out of the vk::Pipeline and set when it is bound instead
+struct DynamicStateSupport {
+    bool enabled = false;               // Core 1.3: cull mode, front face, topology, depth test/write/compare, rasterizer discard
+    bool polygonMode = false;           // VK_EXT_extended_dynamic_state3 from here on
+    bool depthClampEnable = false;
+    bool rasterizationSamples = false;
+    bool colorBlend = false;            // colorBlendEnable + colorBlendEquation
+    bool shaderObject = false;          // VK_EXT_shader_object: every state is dynamic, vertex input included
+
+    bool operator==(const DynamicStateSupport&) const = default;
+};
+
+// Values a dynamic pipeline applies at bind time
+struct DynamicPipelineState {
+    vk::CullModeFlags cullMode {};
+    vk::FrontFace frontFace {};
+    vk::PrimitiveTopology topology {};
+    bool rasterizerDiscardEnable = false;
+    bool depthTestEnable = false;
+    bool depthWriteEnable = false;
+    vk::CompareOp depthCompareOp {};
+
+    vk::PolygonMode polygonMode {};
+    bool depthClampEnable = false;
+    vk::SampleCountFlagBits rasterizationSamples = vk::SampleCountFlagBits::e1;
+    bool colorBlendEnable = false;
+    vk::ColorBlendEquationEXT colorBlendEquation {};
+    uint32_t colorAttachmentCount = 0u;
+
+    // Only applied with shader objects, pipelines bake these
+    std::vector<vk::VertexInputBindingDescription2EXT> vertexBindings;
+    std::vector<vk::VertexInputAttributeDescription2EXT> vertexAttributes;
+};
+
+// Remembers what was last set on a command buffer so binds only emit the states that changed.
+// Tracked per thread: passes may be recorded in parallel, each thread into its own command buffer.
+class DynamicStateCache {
+    private:
+        DynamicStateSupport m_support {};
+
+        struct Tracked {
+            const DynamicStateCache* owner = nullptr;
+            vk::CommandBuffer commandBuffer = nullptr;
+            std::optional<DynamicPipelineState> current;
+        };
+        static Tracked& getTracked();   // The calling thread's
+
+    public:
+        DynamicStateCache() = default;
+        DynamicStateCache(const DynamicStateSupport& support) : m_support(support) {}
+
+    public:
+        void Apply(const vk::raii::CommandBuffer& cmd, const DynamicPipelineState& state);
+
+        // Must be called whenever the command buffer is (re)started or a static pipeline is bound,
+        // on the thread recording it
+        void Invalidate();
+
+    private:
+        void ApplyShaderObjectState(const vk::raii::CommandBuffer& cmd, const DynamicPipelineState& state, const DynamicPipelineState* last);
+};
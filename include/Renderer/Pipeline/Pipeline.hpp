@@ -1,18 +1,80 @@
-#pragma once 
+#pragma once
+
+#include <type_traits>
+
+#include "DynamicState.hpp"
+#include "PipelineDescription.hpp"
+
+// Forward Declarations
+class Buffer;
+
+// Vulkan objects, shared by every description that maps to the same pipeline key
+struct PipelineHandle {
+    vk::raii::Pipeline pipeline = VK_NULL_HANDLE;
+    std::shared_ptr<vk::raii::PipelineLayout> pipelineLayout;   // Shared by graphics pipelines with the same push constant ranges
+    vk::PipelineBindPoint bindPoint = vk::PipelineBindPoint::eGraphics;
+
+    // Set 0 of compute pipelines, written with push descriptors
+    vk::raii::DescriptorSetLayout descriptorSetLayout = VK_NULL_HANDLE;
+
+    // VK_EXT_shader_object backend: replaces `pipeline`
+    std::vector<vk::raii::ShaderEXT> shaders;
+    std::vector<vk::ShaderStageFlagBits> shaderStages;
+    std::vector<vk::ShaderEXT> shaderHandles;
+
+    bool isShaderObject() const { return !shaders.empty(); }
+};
 
 class Pipeline {
     friend class Renderer;
     private:
         std::string name = "";
-        vk::raii::Pipeline pipeline = VK_NULL_HANDLE;
-        vk::raii::PipelineLayout pipelineLayout = VK_NULL_HANDLE;
+        std::shared_ptr<PipelineHandle> handle;     // Null until an async pipeline is compiled
+        std::shared_ptr<const Pipeline> fallback;   // Bound in its place meanwhile
+
+        // Only set when the pipeline was created with dynamic rasterizer/depth state
+        std::optional<DynamicPipelineState> dynamicState;
+        DynamicStateCache* stateCache = nullptr;
 
     public:
         Pipeline() = default;
         Pipeline(const std::string& name) : name(name) {}
 
     public:
-        void Bind(const vk::CommandBuffer& cmdBuffer) const {
-            cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, *pipeline);
+        // Binds the fallback while an async pipeline is compiling. Returns false, binding nothing,
+        // when neither is ready: skip the draw.
+        bool Bind(const vk::raii::CommandBuffer& cmdBuffer) const;
+
+        bool isReady() const { return handle != nullptr; }
+
+        // Shader objects require the *WithCount variants, use these instead of cmd.setViewport/setScissor
+        void SetViewport(const vk::raii::CommandBuffer& cmdBuffer, const vk::Viewport& viewport) const;
+        void SetScissor(const vk::raii::CommandBuffer& cmdBuffer, const vk::Rect2D& scissor) const;
+
+        // Compute pipelines: push a resource into one of the description's bindings, after Bind.
+        // Like Bind, these go to the fallback while the pipeline is not ready, or do nothing.
+        void BindStorageImage(const vk::raii::CommandBuffer& cmdBuffer, uint32_t binding, vk::ImageView view) const;
+        void BindStorageBuffer(const vk::raii::CommandBuffer& cmdBuffer, uint32_t binding, const Buffer& buffer) const;
+        void BindUniformBuffer(const vk::raii::CommandBuffer& cmdBuffer, uint32_t binding, const Buffer& buffer) const;
+
+        // Writes `value` at `offset` of the push constant block, which must be inside a range the
+        // description declared for `stages`. While an async pipeline compiles this goes to its fallback.
+        template<typename T>
+        void PushConstants(const vk::raii::CommandBuffer& cmdBuffer, vk::ShaderStageFlags stages, const T& value, uint32_t offset = 0u) const {
+            static_assert(std::is_trivially_copyable_v<T>, "Push constants are copied byte for byte");
+            static_assert(sizeof(T) % 4u == 0u, "Push constant sizes must be a multiple of 4");
+            static_assert(sizeof(T) <= GUARANTEED_PUSH_CONSTANT_SIZE, "Larger push constants are not supported by every device, use a uniform buffer");
+
+            PushConstantData(cmdBuffer, stages, offset, sizeof(T), &value);
         }
+
+        // Enough workgroups of `localSize` (non-zero) to cover `extent`, skipped when nothing was bound
+        void Dispatch(const vk::raii::CommandBuffer& cmdBuffer, vk::Extent2D extent, vk::Extent2D localSize) const;
+
+        vk::PipelineBindPoint getBindPoint() const { return handle ? handle->bindPoint : vk::PipelineBindPoint::eGraphics; }
+
+        const std::string& getName() const { return name; }
+
+    private:
+        void PushConstantData(const vk::raii::CommandBuffer& cmdBuffer, vk::ShaderStageFlags stages, uint32_t offset, uint32_t size, const void* data) const;
 };
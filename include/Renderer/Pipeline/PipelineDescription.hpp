@@ -5,7 +5,8 @@
 #include "Renderer/Shader/Shader.hpp"
 #include "Renderer/Vertex/VertexInfo.hpp"
 #include "Renderer/Rasterizer/Rasterizer.hpp"
-#include "Renderer/Rasterizer/Rasterizer.hpp"
+#include "DynamicState.hpp"
+#include "SpecializationConstants.hpp"
 
 enum class SampleCount {
     ONE = 0,
@@ -22,28 +23,153 @@ enum class BlendMode {
     ONE_MINUS_SRC_ALPHA
 };
 
+enum class PrimitiveTopology {
+    TRIANGLE_LIST = 0,
+    TRIANGLE_STRIP,
+    LINE_LIST,
+    LINE_STRIP,
+    POINT_LIST
+};
+
+enum class DepthCompare {
+    LESS = 0,
+    LESS_OR_EQUAL,
+    GREATER,
+    GREATER_OR_EQUAL,
+    EQUAL,
+    ALWAYS
+};
+
 enum class ColorAttachmentFormat {
     NONE = 0,
     SWAPCHAIN_FORMAT,
     // TODO: Add formats
 };
 
+// Every device supports at least this many bytes of push constants (maxPushConstantsSize)
+inline constexpr uint32_t GUARANTEED_PUSH_CONSTANT_SIZE = 128u;
+
+// Bytes [offset, offset + size) of the push constant block, visible to `stages`. Offset and size
+// are multiples of 4. Pipelines declaring the same ranges share one layout, so values pushed
+// once stay valid across their binds.
+struct PushConstantRange {
+    vk::ShaderStageFlags stages {};
+    uint32_t offset = 0u;
+    uint32_t size = 0u;
+
+    bool operator==(const PushConstantRange& other) const = default;
+};
+
+struct PushConstantRangesHash {
+    size_t operator()(const std::vector<PushConstantRange>& ranges) const;
+};
+
 struct PipelineDescription {
     std::string name = "";
     GraphicsShader shader {};
     VertexInfo vertexInfo = {};
     Rasterizer rasterizer {};
+    PrimitiveTopology topology = PrimitiveTopology::TRIANGLE_LIST;
     bool depthTestEnabled = true;
     bool depthWriteEnabled = true;
+    DepthCompare depthCompare = DepthCompare::LESS;
     SampleCount sampleCount = SampleCount::ONE;
     BlendMode colorBlend = BlendMode::NONE;
     std::vector<ColorAttachmentFormat> colorAttachments {};
 
+    // Per stage, ignored for a stage the shader does not have
+    SpecializationConstants vertexConstants {};
+    SpecializationConstants fragmentConstants {};
+    SpecializationConstants geometryConstants {};
+
+    std::vector<PushConstantRange> pushConstants {};
+
+    // Compiled in the background (Renderer::RequestPipeline) instead of when the pass is prepared.
+    // Until it is ready the pass binds its pipeline named `fallback`, declared before this one,
+    // or skips the draw when there is none.
+    bool async = false;
+    std::string fallback = "";
+
     bool operator==(const PipelineDescription& other) const {
         return this->name == other.name;
     };
 };
 
+// Structural identity: everything that ends up in the vk::Pipeline, the name excluded.
+// States listed in `dynamicStates` are set at bind time so they do not split pipelines.
+struct PipelineDescriptionHash {
+    DynamicStateSupport dynamicStates {};
+
+    size_t operator()(const PipelineDescription& desc) const;
+};
+
+struct PipelineDescriptionEqual {
+    DynamicStateSupport dynamicStates {};
+
+    bool operator()(const PipelineDescription& a, const PipelineDescription& b) const;
+};
+
+// The four parts of a graphics pipeline library (VK_EXT_graphics_pipeline_library). Each part is
+// keyed only on the fields that end up in it, so descriptions differing elsewhere share it.
+enum class PipelineLibraryPart : uint8_t {
+    VERTEX_INPUT = 0,       // Vertex input, topology
+    PRE_RASTERIZATION,      // Vertex/geometry stages, rasterizer
+    FRAGMENT_SHADER,        // Fragment stage, depth state, sample count
+    FRAGMENT_OUTPUT         // Attachment formats, blending, sample count
+};
+
+template<PipelineLibraryPart part>
+struct PipelineLibraryPartHash {
+    DynamicStateSupport dynamicStates {};
+
+    size_t operator()(const PipelineDescription& desc) const;
+};
+
+template<PipelineLibraryPart part>
+struct PipelineLibraryPartEqual {
+    DynamicStateSupport dynamicStates {};
+
+    bool operator()(const PipelineDescription& a, const PipelineDescription& b) const;
+};
+
+// Resources a compute shader binds, pushed per dispatch (VK_KHR_push_descriptor, optional: creating
+// a compute pipeline with bindings throws without it) in set 0
+enum class DescriptorType {
+    STORAGE_IMAGE = 0,  // Accessed in VK_IMAGE_LAYOUT_GENERAL
+    STORAGE_BUFFER,
+    UNIFORM_BUFFER
+};
+
+struct DescriptorBinding {
+    uint32_t binding = 0u;
+    DescriptorType type = DescriptorType::STORAGE_IMAGE;
+
+    bool operator==(const DescriptorBinding& other) const = default;
+};
+
+struct ComputePipelineDescription {
+    std::string name = "";
+    ComputeShader shader {};
+    std::vector<DescriptorBinding> bindings {};
+    SpecializationConstants constants {};   // Workgroup size included, through `local_size_x_id` and friends
+    std::vector<PushConstantRange> pushConstants {};
+
+    bool operator==(const ComputePipelineDescription& other) const {
+        return this->name == other.name;
+    };
+};
+
+// Structural identity of a compute pipeline: the shader and its bindings, the name excluded
+struct ComputePipelineDescriptionHash {
+    size_t operator()(const ComputePipelineDescription& desc) const;
+};
+
+struct ComputePipelineDescriptionEqual {
+    bool operator()(const ComputePipelineDescription& a, const ComputePipelineDescription& b) const {
+        return a.shader == b.shader && a.bindings == b.bindings && a.constants == b.constants
+            && a.pushConstants == b.pushConstants;
+    }
+};
+
 // WHAT IT ENFORCES:
 //  1. Scissor and Viewport dynamic states
-//  2. Topology as triangles
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <vector>
+#include <cstring>
+#include <cstdint>
+#include <type_traits>
+
+#include "Utils.hpp"
+
+template<typename T>
+concept SpecializationConstant_T = std::is_same_v<T, bool>
+    || std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t> || std::is_same_v<T, float>
+    || std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t> || std::is_same_v<T, double>;
+
+// Values for a stage's `[SpecializationConstant]` / `layout(constant_id = N)` declarations, folded
+// by the driver when the pipeline is built: loop counts, feature toggles, workgroup sizes.
+// Every distinct set of values is a distinct pipeline.
+class SpecializationConstants {
+    private:
+        std::vector<vk::SpecializationMapEntry> m_entries;
+        std::vector<std::byte> m_data;
+
+        // Points into m_entries/m_data, re-pointed whenever those move
+        vk::SpecializationInfo m_info {};
+
+    public:
+        SpecializationConstants() = default;
+
+        SpecializationConstants(const SpecializationConstants& other) : m_entries(other.m_entries), m_data(other.m_data) { Refresh(); }
+        SpecializationConstants(SpecializationConstants&& other) noexcept : m_entries(std::move(other.m_entries)), m_data(std::move(other.m_data)) { Refresh(); }
+
+        SpecializationConstants& operator=(const SpecializationConstants& other) {
+            m_entries = other.m_entries;
+            m_data = other.m_data;
+            Refresh();
+            return *this;
+        }
+        SpecializationConstants& operator=(SpecializationConstants&& other) noexcept {
+            m_entries = std::move(other.m_entries);
+            m_data = std::move(other.m_data);
+            Refresh();
+            return *this;
+        }
+
+    public:
+        // bool is stored as a 32-bit VkBool32, as SPIR-V expects. Setting an id again replaces its value.
+        template<SpecializationConstant_T T>
+        SpecializationConstants& Set(uint32_t constantId, T value) {
+            using Stored = std::conditional_t<std::is_same_v<T, bool>, vk::Bool32, T>;
+            const Stored stored = static_cast<Stored>(value);
+
+            auto entryItr = std::ranges::find(m_entries, constantId, &vk::SpecializationMapEntry::constantID);
+            if (entryItr != m_entries.end() && entryItr->size == sizeof(Stored)) {
+                std::memcpy(m_data.data() + entryItr->offset, &stored, sizeof(Stored));
+                return *this;
+            }
+            if (entryItr != m_entries.end()) {
+                Remove(constantId);
+            }
+
+            m_entries.push_back({
+                    .constantID = constantId,
+                    .offset = static_cast<uint32_t>(m_data.size()),
+                    .size = sizeof(Stored)
+                });
+            m_data.resize(m_data.size() + sizeof(Stored));
+            std::memcpy(m_data.data() + m_entries.back().offset, &stored, sizeof(Stored));
+
+            Refresh();
+            return *this;
+        }
+
+        bool empty() const { return m_entries.empty(); }
+
+        // nullptr when no constant is set, valid until this object is modified or destroyed
+        const vk::SpecializationInfo* getInfo() const { return empty() ? nullptr : &m_info; }
+
+        // Same ids with the same values, whatever order they were set in
+        bool operator==(const SpecializationConstants& other) const {
+            if (m_entries.size() != other.m_entries.size()) return false;
+
+            return std::ranges::all_of(m_entries,
+                    [this, &other] (const vk::SpecializationMapEntry& entry) {
+                        auto otherItr = std::ranges::find(other.m_entries, entry.constantID, &vk::SpecializationMapEntry::constantID);
+                        return otherItr != other.m_entries.end()
+                            && otherItr->size == entry.size
+                            && std::memcmp(m_data.data() + entry.offset, other.m_data.data() + otherItr->offset, entry.size) == 0;
+                    });
+        }
+
+        void Hash(size_t& seed) const {
+            size_t combined = 0u;
+            for (const vk::SpecializationMapEntry& entry : m_entries) {
+                size_t entrySeed = 0u;
+                hashCombine(entrySeed, entry.constantID);
+                for (size_t i = 0; i < entry.size; ++i) {
+                    hashCombine(entrySeed, static_cast<uint8_t>(m_data[entry.offset + i]));
+                }
+                combined += entrySeed;
+            }
+            hashCombine(seed, combined);
+        }
+
+    private:
+        void Remove(uint32_t constantId) {
+            auto entryItr = std::ranges::find(m_entries, constantId, &vk::SpecializationMapEntry::constantID);
+            const vk::SpecializationMapEntry removed = *entryItr;
+            m_entries.erase(entryItr);
+
+            m_data.erase(m_data.begin() + removed.offset, m_data.begin() + removed.offset + removed.size);
+            for (vk::SpecializationMapEntry& entry : m_entries) {
+                if (entry.offset > removed.offset) entry.offset -= static_cast<uint32_t>(removed.size);
+            }
+        }
+
+        void Refresh() {
+            m_info = vk::SpecializationInfo {
+                .mapEntryCount = static_cast<uint32_t>(m_entries.size()),
+                .pMapEntries = m_entries.data(),
+                .dataSize = m_data.size(),
+                .pData = m_data.data()
+            };
+        }
+};
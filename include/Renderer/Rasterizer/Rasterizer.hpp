@@ -20,6 +20,8 @@ enum class FrontFace : uint8_t {
 struct FaceCulling {
     CullFace cullFace = CullFace::NONE;
     FrontFace frontFace = FrontFace::CW;
+
+    bool operator==(const FaceCulling&) const = default;
 };
 
 struct Rasterizer {
@@ -27,5 +29,7 @@ struct Rasterizer {
     bool discardEnable = false;
     PolygonMode polygonMode = PolygonMode::FILL;
     FaceCulling faceCulling {};
+
+    bool operator==(const Rasterizer&) const = default;
 };
 
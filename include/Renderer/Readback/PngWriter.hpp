@@ -0,0 +1,37 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <cstdint>
+#include <filesystem>
+
+#include "Readback.hpp"
+
+// Encodes readbacks to <directory>/<prefix><resource>_<output>_<frame>.png with stb_image_write. Readback callbacks run
+// on job threads, so several frames are encoded in parallel, away from the render thread. Handles
+// 8-bit RGBA and BGRA images (swapchain formats). Must outlive the readbacks using it.
+class PngWriter {
+    private:
+        std::filesystem::path m_directory;
+        std::string m_prefix;
+        bool m_opaque = true;       // Alpha forced to 1, swapchain alpha is meaningless
+
+        std::atomic<uint64_t> m_written = 0u;
+        std::atomic<uint64_t> m_failed = 0u;
+
+    public:
+        PngWriter(std::filesystem::path directory, std::string prefix = "frame_", bool opaque = true);
+
+        PngWriter(const PngWriter&) = delete;
+        PngWriter& operator=(const PngWriter&) = delete;
+
+    public:
+        void Write(const ReadbackImage& image);
+
+        ReadbackCallback getCallback() {
+            return [this] (const ReadbackImage& image) { Write(image); };
+        }
+
+        uint64_t getWrittenCount() const { return m_written.load(std::memory_order_relaxed); }
+        uint64_t getFailedCount() const { return m_failed.load(std::memory_order_relaxed); }
+};
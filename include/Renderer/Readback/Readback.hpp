@@ -0,0 +1,32 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+
+// A graph image copied back to the host, see Renderer::StartReadback()
+struct ReadbackImage {
+    std::string resource = "";
+    uint32_t output = 0u;                   // Renderer::OutputId whose graph it was captured from
+    uint64_t frame = 0u;                    // Renderer frame it was captured in
+    vk::Extent2D extent {};                 // Render extent of the image, mip 0 and layer 0 only
+    vk::Format format {};
+    uint32_t rowPitch = 0u;                 // Bytes, rows are tightly packed
+
+    // Mapped readback memory, only valid during the callback: copy what has to outlive it
+    std::span<const std::byte> pixels;
+};
+
+// Called on a job thread a few frames after the capture, once its fence has signaled. The ring
+// slot is held until it returns: a slow callback makes later captures drop, never the frame rate.
+using ReadbackCallback = std::function<void(const ReadbackImage&)>;
+
+using ReadbackId = uint32_t;
+constexpr ReadbackId INVALID_READBACK_ID = 0u;     // Returned when a readback can never be recorded
+
+struct ReadbackStats {
+    uint64_t completed = 0u;
+    uint64_t dropped = 0u;      // No free slot in the ring when the frame was recorded
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "ImageResource.hpp"
+#include "BufferResource.hpp"
+
+#include <vector>
+
+namespace RenderGraph {
+    // Collects the barriers a pass needs and issues them in a single vkCmdPipelineBarrier2.
+    // Stages and access masks are derived from the layouts on both sides of each transition,
+    // buffers from the use recorded on them by the previous Access().
+    // Passes can use their own batch mid-pass, e.g. between the mips of a single-pass downsample,
+    // when they set RenderPass::midPassBarriers.
+    //
+    // Barriers in one vkCmdPipelineBarrier2 are unordered: a transition of subresources that already
+    // have one in the batch is merged into it when the ranges match, otherwise it goes to a later
+    // group flushed as its own call.
+    class BarrierBatch {
+        private:
+            std::vector<std::vector<vk::ImageMemoryBarrier2>> m_imageBarriers;
+            std::vector<vk::BufferMemoryBarrier2> m_bufferBarriers;
+
+        public:
+            // `range` may use VK_REMAINING_* and an empty aspect mask, see resolveRange()
+            void Transition(ImageResource& image, const vk::ImageSubresourceRange& range, vk::ImageLayout newLayout);
+            void Transition(ImageResource& image, vk::ImageLayout newLayout) {
+                Transition(image, getFullRange(image), newLayout);
+            }
+
+            // Records a use of `buffer`, with a barrier when it follows a write (RAW, WAW) or a write
+            // follows reads (WAR). A read the buffer was already made visible to needs none.
+            void Access(BufferResource& buffer, const BufferSync& sync, bool isWrite);
+
+            void Flush(const vk::raii::CommandBuffer& cmd);
+
+            bool empty() const { return m_imageBarriers.empty() && m_bufferBarriers.empty(); }
+
+        private:
+            void AddImageBarrier(const vk::ImageMemoryBarrier2& barrier);
+    };
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <string>
+#include <vma/vk_mem_alloc.h>
+
+// Stages and accesses of one use of a buffer
+struct BufferSync {
+    vk::PipelineStageFlags2 stages {};
+    vk::AccessFlags2 access {};
+
+    bool operator==(const BufferSync& other) const = default;
+};
+
+// A buffer passes produce and consume through their reads/writes (indirect arguments, particle
+// state, ...). The graph orders its uses: read after write and write after read/write get a
+// buffer barrier in the pass's batch, reads that follow an already synchronized read do not.
+struct BufferResource {
+    std::string name = "";
+    vk::DeviceSize size = 0u;
+    vk::BufferUsageFlags usage {};
+    bool external = false;  // Bound with RenderGraph::BindExternalBuffer instead of allocated
+
+    // Execution-time only
+    vk::Buffer buffer = VK_NULL_HANDLE;
+    VmaAllocation allocation = nullptr;
+    vk::DeviceSize allocatedSize = 0u;
+
+    // Last write and the reads since, what the next barrier on this buffer has to wait for
+    BufferSync lastWrite {};
+    BufferSync readsSinceWrite {};
+
+    bool operator==(const BufferResource& other) const {
+        return name == other.name;
+    }
+};
+
+// How a pass uses a buffer when it does not say otherwise (RenderPass::readBufferSyncs/writeBufferSyncs),
+// from what the buffer was created for. Reads cover every usage, writes are storage or transfer writes.
+inline BufferSync pickBufferSync(const BufferResource& res, bool isWrite) {
+    if (isWrite) {
+        if (res.usage & vk::BufferUsageFlagBits::eStorageBuffer)
+            return { vk::PipelineStageFlagBits2::eComputeShader, vk::AccessFlagBits2::eShaderStorageWrite };
+
+        return { vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferWrite };
+    }
+
+    BufferSync sync {};
+    if (res.usage & vk::BufferUsageFlagBits::eIndirectBuffer) {
+        sync.stages |= vk::PipelineStageFlagBits2::eDrawIndirect;
+        sync.access |= vk::AccessFlagBits2::eIndirectCommandRead;
+    }
+    if (res.usage & vk::BufferUsageFlagBits::eVertexBuffer) {
+        sync.stages |= vk::PipelineStageFlagBits2::eVertexAttributeInput;
+        sync.access |= vk::AccessFlagBits2::eVertexAttributeRead;
+    }
+    if (res.usage & vk::BufferUsageFlagBits::eIndexBuffer) {
+        sync.stages |= vk::PipelineStageFlagBits2::eIndexInput;
+        sync.access |= vk::AccessFlagBits2::eIndexRead;
+    }
+    if (res.usage & vk::BufferUsageFlagBits::eUniformBuffer) {
+        sync.stages |= vk::PipelineStageFlagBits2::eVertexShader | vk::PipelineStageFlagBits2::eFragmentShader | vk::PipelineStageFlagBits2::eComputeShader;
+        sync.access |= vk::AccessFlagBits2::eUniformRead;
+    }
+    if (res.usage & vk::BufferUsageFlagBits::eStorageBuffer) {
+        sync.stages |= vk::PipelineStageFlagBits2::eComputeShader;
+        sync.access |= vk::AccessFlagBits2::eShaderStorageRead;
+    }
+    if (res.usage & vk::BufferUsageFlagBits::eTransferSrc) {
+        sync.stages |= vk::PipelineStageFlagBits2::eTransfer;
+        sync.access |= vk::AccessFlagBits2::eTransferRead;
+    }
+
+    if (!sync.stages) return { vk::PipelineStageFlagBits2::eAllCommands, vk::AccessFlagBits2::eMemoryRead };
+
+    return sync;
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <cstdint>
+
+// On-disk layout of a compiled RenderGraph (RenderGraph::SerializeCompiled / LoadCompiled).
+//
+// Every record is a fixed-size POD at an 8-byte aligned offset from the start of the blob, so the
+// file can be mapped (or read in one go) and used in place without parsing. Names live in a single
+// string table and are referenced by offset/length. The blob is a local cache: it is written in the
+// host's byte order and keyed by hashes that are only stable for a given build.
+//
+//  CompiledGraphHeader
+//  CompiledPass[passCount]              sorted order, inactive (disabled) passes included
+//  CompiledResource[resourceCount]      lifetimes and alias slots
+//  CompiledTransition[transitionCount]  barrier plan, sliced per pass
+//  uint64_t[pipelineKeyCount]           PipelineDescriptionHash of every pipeline, sliced per pass
+//  char[stringBytes]                    string table
+namespace RenderGraph::Compiled {
+    inline constexpr uint32_t MAGIC = 0x42475243u;  // "CRGB"
+    inline constexpr uint32_t VERSION = 2u;
+
+    struct Header {
+        uint32_t magic = MAGIC;
+        uint32_t version = VERSION;
+        uint64_t descriptionHash = 0u;
+
+        uint32_t passCount = 0u;
+        uint32_t resourceCount = 0u;
+        uint32_t transitionCount = 0u;
+        uint32_t pipelineKeyCount = 0u;
+        uint32_t stringBytes = 0u;
+        uint32_t reserved = 0u;
+
+        uint64_t passOffset = 0u;
+        uint64_t resourceOffset = 0u;
+        uint64_t transitionOffset = 0u;
+        uint64_t pipelineKeyOffset = 0u;
+        uint64_t stringOffset = 0u;
+    };
+
+    struct String {
+        uint32_t offset = 0u;
+        uint32_t length = 0u;
+    };
+
+    struct Pass {
+        enum Flags : uint32_t {
+            ACTIVE = 1u << 0
+        };
+
+        String name {};
+        uint32_t firstTransition = 0u;
+        uint32_t transitionCount = 0u;
+        uint32_t firstPipelineKey = 0u;
+        uint32_t pipelineKeyCount = 0u;
+        uint32_t flags = 0u;
+        uint32_t reserved = 0u;
+    };
+
+    struct Resource {
+        String name {};
+        uint32_t firstPass = 0u;
+        uint32_t lastPass = 0u;
+        uint32_t aliasSlot = 0u;
+        uint32_t reserved = 0u;
+    };
+
+    struct Transition {
+        uint32_t resource = 0u;     // Index into the resource records
+        int32_t layout = 0;         // vk::ImageLayout
+        uint32_t aspectMask = 0u;   // vk::ImageSubresourceRange
+        uint32_t baseMipLevel = 0u;
+        uint32_t levelCount = 0u;
+        uint32_t baseArrayLayer = 0u;
+        uint32_t layerCount = 0u;
+        uint32_t reserved = 0u;
+    };
+
+    static_assert(sizeof(Header) == 80u);
+    static_assert(sizeof(Pass) == 32u);
+    static_assert(sizeof(Resource) == 24u);
+    static_assert(sizeof(Transition) == 32u);
+}
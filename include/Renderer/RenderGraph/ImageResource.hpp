@@ -1,31 +1,102 @@
 #pragma once
 
+#include "SubresourceLayouts.hpp"
+
+#include <vma/vk_mem_alloc.h>
+
 #include <type_traits>
 #include <string_view>
 
+// Size of an image as a fraction of another one, e.g. { "BackBuffer", 0.5f } for half resolution
+struct RelativeExtent {
+    std::string relativeTo = "BackBuffer";
+    float scale = 1.0f;
+    bool dynamic = false;   // Scaled by the dynamic resolution controller, allocated at its maximum scale
+};
+
 struct ImageResource {
     std::string name = "";
     vk::Format format {};                    // Pixel format (RGBA8, Depth24Stencil8, etc.)
-    vk::Extent2D extent {};                  // Dimensions in pixels for 2D resources
+    vk::Extent2D extent {};                  // Dimensions in pixels for 2D resources, computed when relativeExtent is set
+    std::optional<RelativeExtent> relativeExtent {};  // Follows the other resource through resizes
+    vk::Extent2D renderExtent {};            // Part of `extent` passes render into, only smaller under dynamic resolution
+    uint32_t mipLevels = 1u;
+    uint32_t arrayLayers = 1u;               // Cascades, cube faces (6), ...
+    vk::SampleCountFlagBits samples = vk::SampleCountFlagBits::e1;
+    std::string resolveTarget = "";          // Multisampled only: resource resolved into at the end of every pass writing this one
     vk::ImageUsageFlags usage {};            // How this resource will be used (color attachment, texture, etc.)
     vk::ImageLayout initialLayout {};        // Expected layout when the frame begins
     vk::ImageLayout finalLayout {};          // Required layout when the frame ends
+    bool external = false;                   // Bound every frame through BindExternalResource (e.g. BackBuffer)
+    bool persistent = false;                 // Contents must survive across frames, never aliased
 
     // Actual GPU resources - populated during compilation
     vk::Image image = nullptr;      // The GPU image object
-    vk::raii::DeviceMemory memory = nullptr;  // Backing memory allocation
+    VmaAllocation allocation = nullptr;  // Backing memory, graph-owned images only
     vk::ImageView view = nullptr;   // Shader-accessible view of the image
+    vk::raii::ImageView ownedView = nullptr;  // Keeps `view` alive for graph-owned images
+    vk::Extent2D allocatedExtent {};          // Extent `image` was created with, reallocated when `extent` changes
+
+    // Execution-time state: layout of every subresource
+    SubresourceLayouts layouts;
+    ImageResource* resolveImage = nullptr;  // `resolveTarget`, looked up by the graph
     
+    // Viewport/scissor/render area size, from the top-left corner
+    vk::Extent2D getRenderExtent() const {
+        return renderExtent.width != 0u ? renderExtent : extent;
+    }
+
     bool operator==(const ImageResource& ir) const {
         return name == ir.name;
     }
 };
 
+inline vk::ImageAspectFlags getAspectMask(vk::Format format) {
+    switch (format) {
+        case vk::Format::eD16Unorm:
+        case vk::Format::eX8D24UnormPack32:
+        case vk::Format::eD32Sfloat:
+            return vk::ImageAspectFlagBits::eDepth;
+        case vk::Format::eD16UnormS8Uint:
+        case vk::Format::eD24UnormS8Uint:
+        case vk::Format::eD32SfloatS8Uint:
+            return vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
+        case vk::Format::eS8Uint:
+            return vk::ImageAspectFlagBits::eStencil;
+        default:
+            return vk::ImageAspectFlagBits::eColor;
+    }
+}
+
+// Every subresource of the image
+inline vk::ImageSubresourceRange getFullRange(const ImageResource& res) {
+    return { getAspectMask(res.format), 0u, res.mipLevels, 0u, res.arrayLayers };
+}
+
+// Clamps `range` to the image: VK_REMAINING_* become counts, an empty aspect mask means every aspect
+inline vk::ImageSubresourceRange resolveRange(const ImageResource& res, const vk::ImageSubresourceRange& range) {
+    const vk::ImageAspectFlags aspects = getAspectMask(res.format);
+    const uint32_t baseMip = std::min(range.baseMipLevel, res.mipLevels);
+    const uint32_t baseLayer = std::min(range.baseArrayLayer, res.arrayLayers);
+
+    return {
+        range.aspectMask ? (range.aspectMask & aspects) : aspects,
+        baseMip,
+        std::min(range.levelCount, res.mipLevels - baseMip),
+        baseLayer,
+        std::min(range.layerCount, res.arrayLayers - baseLayer)
+    };
+}
+
 inline vk::ImageLayout pickLayout(const ImageResource& res, bool isWrite) {
     if (isWrite) {
         if (res.usage & vk::ImageUsageFlagBits::eDepthStencilAttachment)
             return vk::ImageLayout::eDepthStencilAttachmentOptimal;
 
+        // Written by compute (or fragment) shaders only
+        if (!(res.usage & vk::ImageUsageFlagBits::eColorAttachment) && (res.usage & vk::ImageUsageFlagBits::eStorage))
+            return vk::ImageLayout::eGeneral;
+
         return vk::ImageLayout::eColorAttachmentOptimal;
     }
 
@@ -33,5 +104,8 @@ inline vk::ImageLayout pickLayout(const ImageResource& res, bool isWrite) {
     if (res.usage & vk::ImageUsageFlagBits::eSampled)
         return vk::ImageLayout::eShaderReadOnlyOptimal;
 
-    return res.initialLayout; // no-op fallback
+    if (res.usage & vk::ImageUsageFlagBits::eStorage)
+        return vk::ImageLayout::eGeneral;
+
+    return vk::ImageLayout::eUndefined; // no-op fallback: keep whatever layout it is in
 }
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Renderer/RenderGraph/RenderPass.hpp"
+
+#include <span>
+
+namespace RenderGraph {
+    // Stretches the rendered part of `source` (its renderExtent) over the whole of "BackBuffer"
+    // with a linear blit. Meant as the last pass when dynamic resolution is on: `source` needs
+    // eTransferSrc usage, the renderer gives BackBuffer eTransferDst where the surface allows it.
+    // Renderer::EnableDynamicResolution() refuses outputs where the blit is not supported; without
+    // dynamic resolution, a BackBuffer that cannot be blitted into is left untouched.
+    class UpscalePass : public RenderPass {
+        private:
+            std::string m_source;
+
+        public:
+            UpscalePass(const std::string& source)
+                : RenderPass("UpscalePass", { source }, { "BackBuffer" }),
+                  m_source(source) {
+                readLayouts.insert({ source, vk::ImageLayout::eTransferSrcOptimal });
+                writeLayouts.insert({ "BackBuffer", vk::ImageLayout::eTransferDstOptimal });
+            }
+
+        public:
+            const std::string& getSource() const { return m_source; }
+
+            std::span<const PipelineDescription> getPipelineDescriptions() const override { return {}; }
+            std::span<const BufferDescription> getBufferDescriptions() const override { return {}; }
+
+        public:
+            void BeginPass(const vk::raii::CommandBuffer&) override {}
+
+            void RunPass(const vk::raii::CommandBuffer& cmd) override {
+                const ImageResource& source = *readImages.at(m_source);
+                const ImageResource& backBuffer = *writeImages.at("BackBuffer");
+                if (!(backBuffer.usage & vk::ImageUsageFlagBits::eTransferDst)) return;
+
+                const vk::Extent2D sourceExtent = source.getRenderExtent();
+                const vk::ImageBlit region {
+                    .srcSubresource = { vk::ImageAspectFlagBits::eColor, 0u, 0u, 1u },
+                    .srcOffsets = std::array<vk::Offset3D, 2> {
+                        vk::Offset3D { 0, 0, 0 },
+                        vk::Offset3D { static_cast<int32_t>(sourceExtent.width), static_cast<int32_t>(sourceExtent.height), 1 }
+                    },
+                    .dstSubresource = { vk::ImageAspectFlagBits::eColor, 0u, 0u, 1u },
+                    .dstOffsets = std::array<vk::Offset3D, 2> {
+                        vk::Offset3D { 0, 0, 0 },
+                        vk::Offset3D { static_cast<int32_t>(backBuffer.extent.width), static_cast<int32_t>(backBuffer.extent.height), 1 }
+                    }
+                };
+
+                cmd.blitImage(source.image, vk::ImageLayout::eTransferSrcOptimal,
+                        backBuffer.image, vk::ImageLayout::eTransferDstOptimal,
+                        region, vk::Filter::eLinear);
+            }
+
+            void EndPass(const vk::raii::CommandBuffer&) override {}
+    };
+}
@@ -1,9 +1,12 @@
 #pragma once
 
 #include "ImageResource.hpp"
+#include "BufferResource.hpp"
 #include "RenderPass.hpp"
 
-#include <list>
+#include "Utils.hpp"
+
+#include <span>
 #include <memory>
 // #include <ranges>
 #include <string>
@@ -18,6 +21,10 @@ namespace RenderGraph {
         ALREADY_PRESENT,
         ALREADY_COMPILED
     };
+    enum class RemoveResult : uint8_t {
+        OK = 0,
+        DOES_NOT_EXISTS
+    };
     enum class CompileResult : uint8_t {
         OK = 0,
         UNAVAILABLE_RESOURCE,
@@ -30,59 +37,155 @@ namespace RenderGraph {
         OK = 0,
         DOES_NOT_EXISTS
     };
+    enum class LoadCompiledResult : uint8_t {
+        OK = 0,
+        INVALID_BLOB,
+        DESCRIPTION_CHANGED,
+        UNKNOWN_NAME
+    };
 
+    // Where a resource lives in the execution order, indices into getOrderedNodes()
+    struct ResourcePlan {
+        static constexpr uint32_t UNUSED = UINT32_MAX;
+
+        uint32_t firstPass = UNUSED;
+        uint32_t lastPass = UNUSED;
+        uint32_t aliasSlot = UNUSED;    // Resources sharing a slot have disjoint lifetimes and may share memory
+    };
+
+    // The graph stays editable after Compile(): passes and resources can be added, removed,
+    // enabled or disabled at any time and the next Compile() only re-resolves what changed.
     class RenderGraph {
         private:
             std::unordered_map<std::string, ImageResource> m_resources;
+            std::unordered_map<std::string, BufferResource> m_bufferResources;  // Same namespace as images
 
         public:
-            using UnsortedNodes = std::list<std::unique_ptr<RenderPass>>;
-            using OrderedNodes = std::vector<std::unique_ptr<RenderPass>>;
+            using Nodes = std::vector<std::unique_ptr<RenderPass>>;
+            using ExecutionOrder = std::vector<RenderPass*>;
 
         private:
-            std::variant<UnsortedNodes, OrderedNodes> m_nodes;
+            Nodes m_nodes;                      // Every pass, in insertion order
+            ExecutionOrder m_sortedNodes;       // Every schedulable pass, sorted, disabled ones included
+            ExecutionOrder m_executionOrder;    // Active passes, sorted
+
+            // Structural edits need a re-sort, enable toggles only refresh the active set
+            bool m_structureChanged = true;
+            bool m_activityChanged = false;
+            std::unordered_set<std::string> m_changedResources;
+
+            // Barrier plan lives in RenderPass::transitions, lifetimes and aliasing here
+            std::unordered_map<std::string, ResourcePlan> m_resourcePlans;
+
+            // Dynamic resolution: dynamic relative images are allocated at the max scale and rendered at the current one
+            float m_resolutionScale = 1.0f;
+            float m_maxResolutionScale = 1.0f;
+
+            // Handed back to the owner so it can release what they hold once the GPU is done
+            Nodes m_removedNodes;
+            std::vector<ImageResource> m_removedResources;
+            std::vector<BufferResource> m_removedBuffers;
 
         public:
-            RenderGraph() : m_nodes(UnsortedNodes{}) {}
+            RenderGraph() = default;
 
         public:
             template<typename... Args>
             AddResult AddResource(Args&&... args) {
-                if (std::holds_alternative<OrderedNodes>(m_nodes)) {
-                    return AddResult::ALREADY_COMPILED;
-                }  
-
                 ImageResource temp(std::forward<Args>(args)...);
-                if (m_resources.contains(temp.name)) {
+                if (m_resources.contains(temp.name) || m_bufferResources.contains(temp.name)) {
                     return AddResult::ALREADY_PRESENT;
                 }
 
+                m_changedResources.insert(temp.name);
+                m_structureChanged = true;
+
                 m_resources.insert({ temp.name, std::move(temp) });
 
                 return AddResult::OK;
             }
 
+            AddResult AddBufferResource(BufferResource resource) {
+                if (m_resources.contains(resource.name) || m_bufferResources.contains(resource.name)) {
+                    return AddResult::ALREADY_PRESENT;
+                }
+
+                m_changedResources.insert(resource.name);
+                m_structureChanged = true;
+
+                std::string name = resource.name;
+                m_bufferResources.insert({ std::move(name), std::move(resource) });
+
+                return AddResult::OK;
+            }
+
             template<typename T, typename... Args>
             requires isRenderPass<T>
             AddResult AddRenderPass(Args&&... args) {
-                if (std::holds_alternative<OrderedNodes>(m_nodes)) {
-                    return AddResult::ALREADY_COMPILED;
-                }
-                UnsortedNodes& nodes = std::get<UnsortedNodes>(m_nodes);
-
                 std::unique_ptr<RenderPass> temp = std::make_unique<T>(std::forward<Args>(args)...);
-                if (std::ranges::find_if(nodes, 
-                            [&temp] (std::unique_ptr<RenderPass>& pass) {
-                                return *pass == *temp;
-                            }) != nodes.end()) {
+                if (findNode(temp->name) != m_nodes.end()) {
                     return AddResult::ALREADY_PRESENT;
                 }
 
-                nodes.emplace_back(std::move(temp));
+                m_nodes.emplace_back(std::move(temp));
+                m_structureChanged = true;
 
                 return AddResult::OK;
             }
 
+            RemoveResult RemoveRenderPass(const std::string& name) {
+                auto nodeItr = findNode(name);
+                if (nodeItr == m_nodes.end()) {
+                    return RemoveResult::DOES_NOT_EXISTS;
+                }
+
+                m_removedNodes.emplace_back(std::move(*nodeItr));
+                m_nodes.erase(nodeItr);
+                m_structureChanged = true;
+
+                return RemoveResult::OK;
+            }
+
+            RemoveResult RemoveResource(const std::string& name) {
+                auto resourceItr = m_resources.find(name);
+                auto bufferItr = m_bufferResources.find(name);
+                if (resourceItr != m_resources.end()) {
+                    m_removedResources.emplace_back(std::move(resourceItr->second));
+                    m_resources.erase(resourceItr);
+                }
+                else if (bufferItr != m_bufferResources.end()) {
+                    m_removedBuffers.emplace_back(std::move(bufferItr->second));
+                    m_bufferResources.erase(bufferItr);
+                }
+                else {
+                    return RemoveResult::DOES_NOT_EXISTS;
+                }
+
+                m_changedResources.insert(name);
+                m_structureChanged = true;
+
+                return RemoveResult::OK;
+            }
+
+            // A disabled pass is skipped, so are the passes that depend on its outputs
+            RemoveResult SetRenderPassEnabled(const std::string& name, bool enabled) {
+                auto nodeItr = findNode(name);
+                if (nodeItr == m_nodes.end()) {
+                    return RemoveResult::DOES_NOT_EXISTS;
+                }
+
+                if ((*nodeItr)->enabled != enabled) {
+                    (*nodeItr)->enabled = enabled;
+                    m_activityChanged = true;
+                }
+
+                return RemoveResult::OK;
+            }
+
+            bool isDirty() const {
+                return m_structureChanged || m_activityChanged;
+            }
+
         public:
             BindResourceResult BindExternalResource(const std::string& name, vk::Image image, vk::ImageView imageView) {
                 auto _resource = getResource(name);
@@ -91,11 +194,25 @@ namespace RenderGraph {
                 ImageResource& res = _resource.value().get();
                 res.image = image;
                 res.view = imageView;
-                res.initialLayout = vk::ImageLayout::eUndefined;
+                res.layouts.Reset(getAspectMask(res.format), res.mipLevels, res.arrayLayers, vk::ImageLayout::eUndefined);
             
                 return BindResourceResult::OK;
             }
 
+            BindResourceResult BindExternalBuffer(const std::string& name, vk::Buffer buffer) {
+                auto bufferItr = m_bufferResources.find(name);
+                if (bufferItr == m_bufferResources.end()) return BindResourceResult::DOES_NOT_EXISTS;
+
+                BufferResource& resource = bufferItr->second;
+                if (resource.buffer != buffer) {
+                    resource.buffer = buffer;
+                    resource.lastWrite = {};
+                    resource.readsSinceWrite = {};
+                }
+
+                return BindResourceResult::OK;
+            }
+
         public:
             using GetResourceReturnType = std::expected<std::reference_wrapper<ImageResource>, GetResourceError>; 
             GetResourceReturnType getResource(const std::string& name) {
@@ -123,60 +240,77 @@ namespace RenderGraph {
                 return getResource(name).value().get();
             }
 
+            using GetBufferResourceReturnType = std::expected<std::reference_wrapper<BufferResource>, GetResourceError>;
+            GetBufferResourceReturnType getBufferResource(const std::string& name) {
+                auto bufferItr = m_bufferResources.find(name);
+                if (bufferItr == m_bufferResources.end()) {
+                    return std::unexpected(GetResourceError::DOES_NOT_EXISTS);
+                }
+
+                BufferResource& resource = bufferItr->second;
+                return resource;
+            }
+
         public:
+            // Passes whose inputs can never be produced are left out of the execution order and
+            // reported through UNAVAILABLE_RESOURCE, the rest of the graph still runs.
             CompileResult Compile() {
-                if (std::holds_alternative<OrderedNodes>(m_nodes)) {
-                    return CompileResult::ALREADY_COMPILED;
+                if (m_structureChanged) {
+                    UpdateExtents();
+                    ResolveChangedPasses();
+                    Sort();
+                }
+                else if (m_activityChanged) {
+                    RefreshActivePasses();
                 }
 
-                UnsortedNodes& pendingNodes = std::get<UnsortedNodes>(m_nodes);
-                OrderedNodes finalNodes{};
-                finalNodes.reserve(pendingNodes.size());
+                m_structureChanged = false;
+                m_activityChanged = false;
+                m_changedResources.clear();
 
-                std::unordered_set<std::string> availableResources;
-                auto canExecute = [&availableResources] (const RenderPass* renderPass) -> bool {
-                        return renderPass->reads.empty() || std::ranges::all_of(renderPass->reads,
-                            [&availableResources] (const std::string& read) -> bool {
-                                return availableResources.contains(read);
-                            });
-                    };
+                const bool allScheduled = std::ranges::all_of(m_nodes,
+                        [] (const std::unique_ptr<RenderPass>& node) {
+                            return node->scheduled;
+                        });
 
-                
-                std::vector<std::list<std::unique_ptr<RenderPass>>::iterator> toErase;
-                toErase.reserve(pendingNodes.size());
-                while (!pendingNodes.empty()) {
-                    toErase.clear();
-
-                    for (auto itr = pendingNodes.begin(); itr != pendingNodes.end(); ++itr) {
-                        if (canExecute(itr->get())) {
-                            toErase.emplace_back(itr);
-
-                            for (const std::string& input : (*itr)->reads) {
-                                (*itr)->readImages.insert({ input, &m_resources.at(input) });
-                            }
-                            for (const std::string& output : (*itr)->writes) {
-                                (*itr)->writeImages.insert({ output, &m_resources.at(output) });
-                                availableResources.insert(output);
-                            }
-
-                            finalNodes.emplace_back(std::move(*itr));
-                        }
-                    }
+                return allScheduled ? CompileResult::OK : CompileResult::UNAVAILABLE_RESOURCE;
+            }
 
-                    if (toErase.empty()) break;
+        public:
+            // Recomputes the extent of every resource sized relative to another one (after a resize
+            // of "BackBuffer" for instance). Returns the resources whose extent changed.
+            std::vector<std::string> UpdateExtents() {
+                std::vector<std::string> changed;
 
-                    for (const auto& itr : toErase) {
-                        pendingNodes.erase(itr);
-                    }
+                std::unordered_set<std::string> visiting;
+                for (auto& [name, resource] : m_resources) {
+                    if (!resource.relativeExtent) continue;
+
+                    const vk::Extent2D previous = resource.extent;
+                    const vk::Extent2D previousRender = resource.renderExtent;
+                    ResolveExtent(resource, visiting);
+
+                    if (resource.extent != previous || resource.renderExtent != previousRender) changed.push_back(name);
                 }
 
-                if (!pendingNodes.empty()) {
-                    return CompileResult::UNAVAILABLE_RESOURCE;
+                // Alias slots compare extents
+                if (!changed.empty() && !m_structureChanged) {
+                    BuildPlan();
                 }
 
-                m_nodes.emplace<OrderedNodes>(std::move(finalNodes)); // this also destructs UnsortedNodes
+                return changed;
+            }
 
-                return CompileResult::OK;
+            // Only renderExtents change while `maxScale` stays the same, nothing gets reallocated
+            std::vector<std::string> SetResolutionScale(float scale, float maxScale) {
+                m_resolutionScale = std::min(scale, maxScale);
+                m_maxResolutionScale = maxScale;
+
+                return UpdateExtents();
+            }
+
+            float getResolutionScale() const {
+                return m_resolutionScale;
             }
 
         public:
@@ -184,21 +318,303 @@ namespace RenderGraph {
                 NOT_COMPILED,
                 NO_NODES
             };
-            std::expected<std::reference_wrapper<const OrderedNodes>, GetNodesError> getOrderedNodes() const {
-                if (std::holds_alternative<UnsortedNodes>(m_nodes)) {
+            std::expected<std::reference_wrapper<const ExecutionOrder>, GetNodesError> getOrderedNodes() const {
+                if (m_structureChanged) {
                     return std::unexpected(RenderGraph::GetNodesError::NOT_COMPILED);
                 }
-                const OrderedNodes& nodes = std::get<OrderedNodes>(m_nodes);
 
-                if (nodes.empty()) {
+                if (m_executionOrder.empty()) {
                     return std::unexpected(RenderGraph::GetNodesError::NO_NODES);
                 }
 
-                return nodes;
+                return m_executionOrder;
+            }
+
+            // Every pass, active or not
+            const Nodes& getNodes() const {
+                return m_nodes;
+            }
+
+            std::unordered_map<std::string, ImageResource>& getResources() {
+                return m_resources;
+            }
+
+            std::unordered_map<std::string, BufferResource>& getBufferResources() {
+                return m_bufferResources;
+            }
+
+            // Empty until the first Compile()/LoadCompiled()
+            const std::unordered_map<std::string, ResourcePlan>& getResourcePlans() const {
+                return m_resourcePlans;
+            }
+
+            Nodes TakeRemovedNodes() {
+                return std::exchange(m_removedNodes, {});
+            }
+
+            std::vector<ImageResource> TakeRemovedResources() {
+                return std::exchange(m_removedResources, {});
+            }
+
+            std::vector<BufferResource> TakeRemovedBuffers() {
+                return std::exchange(m_removedBuffers, {});
+            }
+
+        public:
+            // Compiled graph cache (CompiledGraph.cpp), see CompiledGraph.hpp for the format.
+            // The description hash covers everything Compile() depends on plus the pipeline keys
+            // of every pass, a blob is only loaded when it matches the current graph.
+            uint64_t getDescriptionHash(const PipelineDescriptionHash& pipelineHash) const;
+            ByteArray SerializeCompiled(uint64_t descriptionHash, const PipelineDescriptionHash& pipelineHash) const;
+            // Replaces Compile() on success, on failure the graph is left dirty and Compile() still works
+            LoadCompiledResult LoadCompiled(std::span<const std::byte> blob, uint64_t descriptionHash);
+
+        private:
+            // Chains (quarter of half of BackBuffer) resolve their base first, cycles are left as they are
+            void ResolveExtent(ImageResource& resource, std::unordered_set<std::string>& visiting) {
+                if (!resource.relativeExtent || !visiting.insert(resource.name).second) return;
+
+                auto baseItr = m_resources.find(resource.relativeExtent->relativeTo);
+                if (baseItr != m_resources.end()) {
+                    ImageResource& base = baseItr->second;
+                    ResolveExtent(base, visiting);
+
+                    auto scaled = [] (vk::Extent2D extent, float scale) {
+                        return vk::Extent2D {
+                            std::max(1u, static_cast<uint32_t>(static_cast<float>(extent.width) * scale)),
+                            std::max(1u, static_cast<uint32_t>(static_cast<float>(extent.height) * scale))
+                        };
+                    };
+
+                    const RelativeExtent& relative = resource.relativeExtent.value();
+                    resource.extent = scaled(base.extent, relative.scale * (relative.dynamic ? m_maxResolutionScale : 1.0f));
+                    resource.renderExtent = scaled(base.getRenderExtent(), relative.scale * (relative.dynamic ? m_resolutionScale : 1.0f));
+                }
+
+                visiting.erase(resource.name);
+            }
+
+            Nodes::iterator findNode(const std::string& name) {
+                return std::ranges::find_if(m_nodes,
+                        [&name] (const std::unique_ptr<RenderPass>& pass) {
+                            return pass->name == name;
+                        });
+            }
+
+            static bool references(const RenderPass& pass, const std::unordered_set<std::string>& names) {
+                auto contains = [&names] (const std::string& name) { return names.contains(name); };
+                return std::ranges::any_of(pass.reads, contains)
+                    || std::ranges::any_of(pass.writes, contains)
+                    || std::ranges::any_of(pass.resolveWrites, contains);
+            }
+
+            // Only new passes and passes touching added/removed resources get their pointers rebuilt
+            void ResolveChangedPasses() {
+                for (std::unique_ptr<RenderPass>& node : m_nodes) {
+                    if (node->resolved && !references(*node, m_changedResources)) continue;
+
+                    node->readImages.clear();
+                    node->writeImages.clear();
+                    node->readBuffers.clear();
+                    node->writeBuffers.clear();
+                    node->resolveWrites.clear();
+                    node->resolved = true;
+
+                    // Names are looked up among images first, then buffers
+                    auto resolve = [this, &node] (const std::string& name, auto& images, auto& buffers) {
+                        if (auto resourceItr = m_resources.find(name); resourceItr != m_resources.end()) {
+                            images.insert({ name, &resourceItr->second });
+                        }
+                        else if (auto bufferItr = m_bufferResources.find(name); bufferItr != m_bufferResources.end()) {
+                            buffers.insert({ name, &bufferItr->second });
+                        }
+                        else {
+                            node->resolved = false;
+                        }
+                    };
+
+                    for (const std::string& input : node->reads) resolve(input, node->readImages, node->readBuffers);
+                    for (const std::string& output : node->writes) resolve(output, node->writeImages, node->writeBuffers);
+
+                    // Writing a multisampled image also writes the image it resolves into
+                    for (const std::string& output : node->writes) {
+                        auto resourceItr = m_resources.find(output);
+                        if (resourceItr == m_resources.end()) continue;
+
+                        ImageResource& image = resourceItr->second;
+                        if (image.samples == vk::SampleCountFlagBits::e1 || image.resolveTarget.empty()) continue;
+
+                        auto targetItr = m_resources.find(image.resolveTarget);
+                        image.resolveImage = targetItr == m_resources.end() ? nullptr : &targetItr->second;
+                        node->resolveWrites.push_back(image.resolveTarget);
+
+                        if (!image.resolveImage) node->resolved = false;
+                        else node->writeImages.insert({ image.resolveTarget, image.resolveImage });
+                    }
+                }
+            }
+
+            void Sort() {
+                for (std::unique_ptr<RenderPass>& node : m_nodes) {
+                    node->scheduled = false;
+                }
+
+                ExecutionOrder sorted;
+                sorted.reserve(m_nodes.size());
+
+                std::unordered_set<std::string> availableResources;
+                auto canExecute = [&availableResources] (const RenderPass* renderPass) -> bool {
+                        return renderPass->reads.empty() || std::ranges::all_of(renderPass->reads,
+                            [&availableResources] (const std::string& read) -> bool {
+                                return availableResources.contains(read);
+                            });
+                    };
+
+                bool progress = true;
+                while (progress) {
+                    progress = false;
+
+                    for (std::unique_ptr<RenderPass>& node : m_nodes) {
+                        if (node->scheduled || !node->resolved || !canExecute(node.get())) continue;
+
+                        for (const std::string& output : node->writes) {
+                            availableResources.insert(output);
+                        }
+                        for (const std::string& output : node->resolveWrites) {
+                            availableResources.insert(output);
+                        }
+
+                        node->scheduled = true;
+                        sorted.push_back(node.get());
+                        progress = true;
+                    }
+                }
+
+                m_sortedNodes = std::move(sorted);
+                RefreshActivePasses();
+            }
+
+            // Walks the sorted passes: a pass runs if it is enabled and every input has an active producer
+            void RefreshActivePasses() {
+                m_executionOrder.clear();
+                m_executionOrder.reserve(m_sortedNodes.size());
+
+                std::unordered_set<std::string> producedResources;
+                for (RenderPass* node : m_sortedNodes) {
+                    node->active = node->enabled && std::ranges::all_of(node->reads,
+                            [&producedResources] (const std::string& read) -> bool {
+                                return producedResources.contains(read);
+                            });
+
+                    if (!node->active) continue;
+
+                    for (const std::string& output : node->writes) {
+                        producedResources.insert(output);
+                    }
+                    for (const std::string& output : node->resolveWrites) {
+                        producedResources.insert(output);
+                    }
+                    m_executionOrder.push_back(node);
+                }
+
+                BuildPlan();
             }
 
-            OrderedNodes& getOrderedNodesUnsafe() {
-                return const_cast<OrderedNodes&>(getOrderedNodes().value().get());
+            // Per-pass layout transitions, then resource lifetimes over the execution order and a
+            // greedy interval packing of the transient ones into alias slots
+            void BuildPlan() {
+                m_resourcePlans.clear();
+
+                for (uint32_t passIndex = 0u; passIndex < m_executionOrder.size(); ++passIndex) {
+                    RenderPass* node = m_executionOrder[passIndex];
+                    node->transitions.clear();
+
+                    auto plan = [this, node, passIndex] (const std::string& name, ImageResource* image, bool isWrite) {
+                        ResourcePlan& resourcePlan = m_resourcePlans[name];
+                        if (resourcePlan.firstPass == ResourcePlan::UNUSED) resourcePlan.firstPass = passIndex;
+                        resourcePlan.lastPass = passIndex;
+
+                        const auto& layouts = isWrite ? node->writeLayouts : node->readLayouts;
+                        const auto layoutItr = layouts.find(name);
+                        const vk::ImageLayout layout = layoutItr == layouts.end() ? pickLayout(*image, isWrite) : layoutItr->second;
+                        if (layout == vk::ImageLayout::eUndefined) return;
+
+                        const auto& ranges = isWrite ? node->writeRanges : node->readRanges;
+                        const auto rangeItr = ranges.find(name);
+                        const vk::ImageSubresourceRange range = rangeItr == ranges.end()
+                            ? getFullRange(*image)
+                            : resolveRange(*image, rangeItr->second);
+
+                        auto transitionItr = std::ranges::find_if(node->transitions,
+                                [image, &range] (const PlannedTransition& transition) {
+                                    return transition.resource == image && transition.range == range;
+                                });
+                        if (transitionItr == node->transitions.end()) node->transitions.push_back({ image, range, layout });
+                        else if (isWrite) transitionItr->layout = layout;  // Writes win over reads of the same subresources
+                    };
+
+                    // Reads first: where read and write ranges overlap the write layout is applied last
+                    for (const auto& [name, image] : node->readImages) plan(name, image, false);
+                    for (const auto& [name, image] : node->writeImages) plan(name, image, true);
+                }
+
+                BuildBufferPlan();
+
+                std::vector<std::pair<const std::string*, ResourcePlan*>> transient;
+                for (auto& [name, resourcePlan] : m_resourcePlans) {
+                    const ImageResource& image = m_resources.at(name);
+                    if (!image.external && !image.persistent) transient.emplace_back(&name, &resourcePlan);
+                }
+                std::ranges::sort(transient, {}, [] (const auto& entry) { return entry.second->firstPass; });
+
+                // Slot -> last pass of the resource currently holding it, plus what it was created as
+                struct Slot { uint32_t lastPass; const ImageResource* image; };
+                std::vector<Slot> slots;
+                for (auto& [name, resourcePlan] : transient) {
+                    const ImageResource& image = m_resources.at(*name);
+                    auto compatible = [&image, resourcePlan] (const Slot& slot) {
+                        return slot.lastPass < resourcePlan->firstPass
+                            && slot.image->format == image.format
+                            && slot.image->extent == image.extent
+                            && slot.image->usage == image.usage;
+                    };
+
+                    auto slotItr = std::ranges::find_if(slots, compatible);
+                    if (slotItr == slots.end()) {
+                        resourcePlan->aliasSlot = static_cast<uint32_t>(slots.size());
+                        slots.push_back({ resourcePlan->lastPass, &image });
+                    }
+                    else {
+                        resourcePlan->aliasSlot = static_cast<uint32_t>(std::distance(slots.begin(), slotItr));
+                        slotItr->lastPass = resourcePlan->lastPass;
+                    }
+                }
+            }
+
+            // Buffer uses of every active pass. Cheap enough to rebuild after LoadCompiled() instead of caching.
+            void BuildBufferPlan() {
+                for (RenderPass* node : m_executionOrder) {
+                    node->bufferAccesses.clear();
+
+                    auto plan = [node] (const std::string& name, BufferResource* buffer, bool isWrite) {
+                        const auto& syncs = isWrite ? node->writeBufferSyncs : node->readBufferSyncs;
+                        const auto syncItr = syncs.find(name);
+                        const BufferSync sync = syncItr == syncs.end() ? pickBufferSync(*buffer, isWrite) : syncItr->second;
+
+                        auto accessItr = std::ranges::find(node->bufferAccesses, buffer, &PlannedBufferAccess::resource);
+                        if (accessItr == node->bufferAccesses.end()) {
+                            node->bufferAccesses.push_back({ buffer, sync, isWrite });
+                            return;
+                        }
+
+                        accessItr->sync.stages |= sync.stages;
+                        accessItr->sync.access |= sync.access;
+                        accessItr->write = accessItr->write || isWrite;
+                    };
+
+                    for (const auto& [name, buffer] : node->readBuffers) plan(name, buffer, false);
+                    for (const auto& [name, buffer] : node->writeBuffers) plan(name, buffer, true);
+                }
             }
     };
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "ImageResource.hpp"
+#include "BufferResource.hpp"
 #include "Renderer/Buffer/BufferDescription.hpp"
 #include "Renderer/Pipeline/PipelineDescription.hpp"
 
@@ -12,6 +13,20 @@ class Pipeline;
 class Buffer;
 
 namespace RenderGraph {
+    // Layout part of an image must be in before a pass runs, computed by RenderGraph::Compile()
+    struct PlannedTransition {
+        ImageResource* resource = nullptr;
+        vk::ImageSubresourceRange range {};     // Resolved against the resource
+        vk::ImageLayout layout {};
+    };
+
+    // Use of a graph buffer by a pass, ordered against the previous ones at execution
+    struct PlannedBufferAccess {
+        BufferResource* resource = nullptr;
+        BufferSync sync {};
+        bool write = false;     // A pass reading and writing the same buffer has one write access
+    };
+
     class RenderPass {
         public:
             friend class RenderGraph;
@@ -22,14 +37,64 @@ namespace RenderGraph {
             std::vector<std::string> reads {};
             std::vector<std::string> writes {};
 
+            // Narrows a read/write to part of an image (mips, layers, aspects), by default a pass
+            // touches every subresource. The same image may be read through one range and written
+            // through another, e.g. read mip N and write mip N+1.
+            std::unordered_map<std::string, vk::ImageSubresourceRange> readRanges {};
+            std::unordered_map<std::string, vk::ImageSubresourceRange> writeRanges {};
+
+            // Layout a pass needs an image in when its usage does not imply it (transfers, storage).
+            // Storage images go in eGeneral, consecutive eGeneral uses are still ordered by a barrier.
+            std::unordered_map<std::string, vk::ImageLayout> readLayouts {};
+            std::unordered_map<std::string, vk::ImageLayout> writeLayouts {};
+
+            // Graph buffers in reads/writes: how they are used when their usage does not say, see pickBufferSync()
+            std::unordered_map<std::string, BufferSync> readBufferSyncs {};
+            std::unordered_map<std::string, BufferSync> writeBufferSyncs {};
+
+            // Static passes record BeginPass/RunPass/EndPass once per frame in flight and swapchain image
+            // into secondary command buffers, replayed with executeCommands. They are recorded again after
+            // BumpVersion() or when something they reference changes: images (resized, reallocated),
+            // buffers, pipelines. Anything else they record (per-frame push constants, ...) is frozen
+            // until the version is bumped.
+            // A replay does not run the pass's code, so static passes cannot have midPassBarriers.
+            bool recordOnce = false;
+
+            // Set by passes that flush their own BarrierBatch between BeginPass and EndPass. Those update
+            // the resources' tracked layouts and accesses, so the pass is recorded on the render thread
+            // after the barriers of the passes before it, never by a job.
+            bool midPassBarriers = false;
+
             // Execution-time only
             std::unordered_map<std::string, ImageResource*> readImages;
             std::unordered_map<std::string, ImageResource*> writeImages;
+            std::vector<PlannedTransition> transitions;
+            std::unordered_map<std::string, BufferResource*> readBuffers;
+            std::unordered_map<std::string, BufferResource*> writeBuffers;
+            std::vector<PlannedBufferAccess> bufferAccesses;
 
             std::unordered_map<std::string, std::shared_ptr<const Pipeline>> pipelines;
             std::unordered_map<std::string, std::shared_ptr<const Buffer>> buffers;
 
-            Renderer* renderer;
+            Renderer* renderer = nullptr;
+
+        private:
+            std::vector<std::string> resolveWrites;  // Resolve targets of multisampled writes, implicitly written too
+
+            // Static passes: one per frame in flight and swapchain image, at imageIndex * MAX_FRAMES_IN_FLIGHT
+            // + frameIndex, replayed while `key` matches what the pass references
+            struct RecordedCommands {
+                vk::raii::CommandBuffer buffer = nullptr;
+                size_t key = 0u;
+                bool recorded = false;
+            };
+            std::vector<RecordedCommands> recordedCommands;
+            uint64_t version = 0u;
+
+            bool enabled = true;
+            bool active = false;     // Enabled and every input has an active producer
+            bool scheduled = false;  // Has a place in the sorted order
+            bool resolved = false;   // readImages/writeImages point at live resources
 
         public:
             RenderPass(std::string&& name, const std::vector<std::string>& reads, const std::vector<std::string>& writes)
@@ -41,12 +106,50 @@ namespace RenderGraph {
         public:
             virtual std::span<const PipelineDescription> getPipelineDescriptions() const = 0;
             virtual std::span<const BufferDescription> getBufferDescriptions() const = 0;
+            virtual std::span<const ComputePipelineDescription> getComputePipelineDescriptions() const { return {}; }
 
         public:
             virtual void BeginPass(const vk::raii::CommandBuffer& cmd) = 0;
             virtual void RunPass(const vk::raii::CommandBuffer& cmd) = 0;
             virtual void EndPass(const vk::raii::CommandBuffer& cmd) = 0;
 
+        protected:
+            // Attachment for a written image. Multisampled images with a resolveTarget resolve into it
+            // when rendering ends, the multisampled contents can then usually be stored with eDontCare.
+            vk::RenderingAttachmentInfo getAttachmentInfo(const std::string& image, vk::AttachmentLoadOp loadOp,
+                    vk::AttachmentStoreOp storeOp, vk::ClearValue clearValue = {}) const {
+                const ImageResource& resource = *writeImages.at(image);
+
+                vk::RenderingAttachmentInfo attachmentInfo {
+                    .imageView   = resource.view,
+                    .imageLayout = pickLayout(resource, true),
+                    .loadOp      = loadOp,
+                    .storeOp     = storeOp,
+                    .clearValue  = clearValue
+                };
+
+                if (resource.samples != vk::SampleCountFlagBits::e1 && resource.resolveImage) {
+                    const bool isColor = static_cast<bool>(getAspectMask(resource.format) & vk::ImageAspectFlagBits::eColor);
+
+                    // Depth/stencil can only average on some devices, sample zero always works
+                    attachmentInfo.resolveMode = isColor ? vk::ResolveModeFlagBits::eAverage : vk::ResolveModeFlagBits::eSampleZero;
+                    attachmentInfo.resolveImageView = resource.resolveImage->view;
+                    attachmentInfo.resolveImageLayout = pickLayout(*resource.resolveImage, true);
+                }
+
+                return attachmentInfo;
+            }
+
+        public:
+            const std::string& getName() const { return name; }
+            bool isEnabled() const { return enabled; }
+            bool isActive() const { return active; }
+            bool isStatic() const { return recordOnce; }
+
+            // A static pass's inputs changed: record it again next frame
+            void BumpVersion() { ++version; }
+            uint64_t getVersion() const { return version; }
+
         public:
             bool operator==(const RenderPass& pass) const {
                 return name == pass.name;
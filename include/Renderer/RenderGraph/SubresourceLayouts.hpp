@@ -0,0 +1,52 @@
+#pragma once
+
+#include <span>
+#include <array>
+#include <vector>
+#include <cstdint>
+
+// A layout change for a block of subresources that all start from the same layout
+struct LayoutTransition {
+    vk::ImageSubresourceRange range {};
+    vk::ImageLayout oldLayout {};
+};
+
+// Tracks the layout of every (aspect, array layer, mip level) of an image, so passes can work on
+// part of an image (read mip N while writing mip N+1, one cascade, one cube face) without
+// serializing on the whole of it.
+class SubresourceLayouts {
+    private:
+        static constexpr std::array<vk::ImageAspectFlagBits, 3> ASPECTS {
+            vk::ImageAspectFlagBits::eColor,
+            vk::ImageAspectFlagBits::eDepth,
+            vk::ImageAspectFlagBits::eStencil
+        };
+
+        vk::ImageAspectFlags m_aspects {};
+        uint32_t m_mipLevels = 0u;
+        uint32_t m_arrayLayers = 0u;
+
+        // [aspect][layer][mip], aspects in ASPECTS order, only the tracked ones
+        std::vector<vk::ImageLayout> m_layouts;
+
+    public:
+        void Reset(vk::ImageAspectFlags aspects, uint32_t mipLevels, uint32_t arrayLayers, vk::ImageLayout layout);
+
+        bool isTracking(vk::ImageAspectFlags aspects, uint32_t mipLevels, uint32_t arrayLayers) const {
+            return m_aspects == aspects && m_mipLevels == mipLevels && m_arrayLayers == arrayLayers;
+        }
+
+        vk::ImageLayout getLayout(vk::ImageAspectFlagBits aspect, uint32_t mipLevel, uint32_t arrayLayer) const;
+
+        // Moves `range` (already resolved, no VK_REMAINING_*) to `newLayout` and returns what actually
+        // changed, merged into as few ranges as possible: mips first, then layers, then depth+stencil.
+        // With `includeUnchanged` subresources already in `newLayout` are returned too (oldLayout ==
+        // newLayout), for layouts like eGeneral whose uses still need ordering.
+        std::vector<LayoutTransition> Transition(const vk::ImageSubresourceRange& range, vk::ImageLayout newLayout, bool includeUnchanged = false);
+
+    private:
+        uint32_t getAspectIndex(vk::ImageAspectFlagBits aspect) const;
+        size_t getIndex(uint32_t aspectIndex, uint32_t mipLevel, uint32_t arrayLayer) const {
+            return (static_cast<size_t>(aspectIndex) * m_arrayLayers + arrayLayer) * m_mipLevels + mipLevel;
+        }
+};
@@ -34,3 +34,13 @@ class CreateAllocatorError : public std::runtime_error {
     public:
         CreateAllocatorError(const std::string& msg) : std::runtime_error(msg) {}
 };
+
+class CreateImageError : public std::runtime_error {
+    public:
+        CreateImageError(const std::string& msg) : std::runtime_error(msg) {}
+};
+
+class CreateBufferError : public std::runtime_error {
+    public:
+        CreateBufferError(const std::string& msg) : std::runtime_error(msg) {}
+};
@@ -1,18 +1,42 @@
 #pragma once
 
+#include <span>
+#include <deque>
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <exception>
 #include <string>
 #include <vector>
+#include <future>
+#include <functional>
+#include <thread>
+#include <unordered_map>
+#include <condition_variable>
 
 #include <vma/vk_mem_alloc.h>
 #include "Pipeline/PipelineDescription.hpp"
 #include "Renderer/Shader/Shader.hpp"
 #include "Buffer/Buffer.hpp"
+#include "DeletionQueue/DeletionQueue.hpp"
+#include "Output/RenderOutput.hpp"
+#include "CommandPools/FrameCommandPools.hpp"
+#include "Frame/FrameSnapshot.hpp"
+#include "Frame/FrameMailbox.hpp"
+#include "Jobs/JobSystem.hpp"
+#include "Memory/MemoryTracker.hpp"
+#include "Readback/Readback.hpp"
 
 // Forward Declarations
 class GLFWwindow;
 class Pipeline;
+struct PipelineHandle;
+struct ImageResource;
+struct BufferResource;
 namespace RenderGraph { 
     class RenderGraph;
+    class RenderPass;
+    class BarrierBatch;
 }
 namespace Extensions {
     struct Extension;
@@ -46,17 +70,12 @@ namespace DeviceExtensions {
 }
 
 class Renderer {
-    private:
-        GLFWwindow* m_window = nullptr;
-
     private:
         vk::raii::Context m_context;
 
         vk::raii::Instance m_instance = VK_NULL_HANDLE;
         vk::raii::DebugUtilsMessengerEXT m_debugMessenger = VK_NULL_HANDLE;
 
-        vk::raii::SurfaceKHR m_surface = VK_NULL_HANDLE;
-
         vk::raii::PhysicalDevice m_physicalDevice = VK_NULL_HANDLE;
         vk::raii::Device m_device = VK_NULL_HANDLE;
 
@@ -64,29 +83,165 @@ class Renderer {
         vk::raii::Queue m_graphicsQueue = VK_NULL_HANDLE;
         vk::raii::Queue m_transferQueue = VK_NULL_HANDLE;
 
-        vk::raii::SwapchainKHR m_swapChain = VK_NULL_HANDLE;
-        std::vector<vk::Image> m_swapChainImages;
-        std::vector<vk::raii::ImageView> m_swapChainImageViews;
-
-        vk::Extent2D m_swapChainExtent = {};
-        vk::SurfaceFormatKHR m_SwapChainSurfaceFormat = {};
-
+        // Persistent: command buffers recorded once and kept (static passes)
         vk::raii::CommandPool m_commandPool = VK_NULL_HANDLE;
-        std::vector<vk::raii::CommandBuffer> m_commandBuffers;
 
+        // Transient, one set per frame in flight: everything recorded for a single frame
+        std::vector<std::unique_ptr<FrameCommandPools>> m_frameCommandPools;
+
+        // One fence per frame in flight covers the single submit of every output
         std::vector<vk::raii::Fence> m_framesInFlightFence;
-        std::vector<vk::raii::Semaphore> m_presentCompleteSemaphores;
-        std::vector<vk::raii::Semaphore> m_renderFinishedSemaphores;
 
-        std::unique_ptr<RenderGraph::RenderGraph> m_renderGraph;
+        // The primary output is created by Init(), the others by AddOutput()
+        std::vector<std::unique_ptr<RenderOutput>> m_outputs;
 
         std::vector<std::shared_ptr<Pipeline>> m_pipelines;
+
+        // Structurally identical descriptions share one vk::Pipeline
+        using PipelineRegistry = std::unordered_map<PipelineDescription, std::shared_ptr<PipelineHandle>, PipelineDescriptionHash, PipelineDescriptionEqual>;
+        PipelineRegistry m_pipelineRegistry;
+
+        using ComputePipelineRegistry = std::unordered_map<ComputePipelineDescription, std::shared_ptr<PipelineHandle>, ComputePipelineDescriptionHash, ComputePipelineDescriptionEqual>;
+        ComputePipelineRegistry m_computePipelineRegistry;
+
+        // VK_EXT_graphics_pipeline_library: parts shared by every pipeline that has the same
+        // sub-fields, fast-linked on first use
+        template<PipelineLibraryPart part>
+        using PipelineLibraryCache = std::unordered_map<PipelineDescription, std::shared_ptr<vk::raii::Pipeline>, PipelineLibraryPartHash<part>, PipelineLibraryPartEqual<part>>;
+        PipelineLibraryCache<PipelineLibraryPart::VERTEX_INPUT> m_vertexInputLibraries;
+        PipelineLibraryCache<PipelineLibraryPart::PRE_RASTERIZATION> m_preRasterizationLibraries;
+        PipelineLibraryCache<PipelineLibraryPart::FRAGMENT_SHADER> m_fragmentShaderLibraries;
+        PipelineLibraryCache<PipelineLibraryPart::FRAGMENT_OUTPUT> m_fragmentOutputLibraries;
+
+        // Link-time optimized versions of fast-linked pipelines, swapped in between frames once ready
+        struct OptimizedLink {
+            std::weak_ptr<PipelineHandle> handle;
+            std::future<vk::raii::Pipeline> pipeline;
+        };
+        std::vector<OptimizedLink> m_optimizedLinks;   // Guarded by m_optimizedLinkMutex
+        std::mutex m_optimizedLinkMutex;
+
+        // Pipelines requested with RequestPipeline: compiled by jobs, handed to the Pipelines
+        // waiting on them between frames
+        struct PipelineCompileJob {
+            PipelineDescription desc;
+            std::shared_ptr<PipelineHandle> handle;         // Written by the job
+            std::string error = "";                         // Written by the job, empty on success
+            std::vector<std::shared_ptr<Pipeline>> waiting; // Render thread only
+        };
+        std::vector<std::shared_ptr<PipelineCompileJob>> m_pendingCompiles;    // Requested, not published yet. Render thread only.
+        std::atomic<uint32_t> m_pendingCompileCount = 0u;                      // m_pendingCompiles.size(), for the stats
+
+        std::mutex m_compileMutex;
+        std::vector<std::shared_ptr<PipelineCompileJob>> m_compiledJobs;    // Guarded by m_compileMutex
+        std::atomic<uint32_t> m_queuedCompiles = 0u;
+        std::atomic<uint32_t> m_runningCompiles = 0u;
+        std::atomic<bool> m_stopCompiles = false;      // Queued compiles are skipped, at shutdown
+
+        // Compiles and optimized links, waited for before the device goes away
+        JobCounter m_backgroundJobs;
+
+        std::atomic<uint64_t> m_pipelinesCompiled = 0u;
+        std::atomic<uint64_t> m_pipelinesFailed = 0u;
+
+        // Graphics pipelines declaring the same push constant ranges share a layout, so pushed
+        // values survive binding one after the other
+        using PipelineLayoutCache = std::unordered_map<std::vector<PushConstantRange>, std::shared_ptr<vk::raii::PipelineLayout>, PushConstantRangesHash>;
+        mutable PipelineLayoutCache m_pipelineLayouts;
+        mutable std::mutex m_pipelineLayoutMutex;
+
+        // Compile threads share shader modules and library parts with the render thread. Held only
+        // for cache lookups and inserts, never while compiling.
+        mutable std::mutex m_shaderModuleMutex;
+        std::mutex m_pipelineLibraryMutex;
+
+        // SWAPCHAIN_FORMAT attachments: the primary output's format, shared by every output
+        vk::Format m_swapChainFormat = vk::Format::eUndefined;
+
+        bool m_pipelineLibrariesSupported = false;
+        bool m_pipelineLibraries = false;
+        bool m_optimizeLinkedPipelines = false;
+
+        bool m_shaderObjectsSupported = false;
+        bool m_pushDescriptorSupported = false;     // Compute pipeline bindings
+        DynamicStateSupport m_supportedDynamicStates {};
+        DynamicStateSupport m_dynamicStates {};
+        DynamicStateCache m_dynamicStateCache;
         std::vector<std::shared_ptr<Buffer>> m_buffers;
 
         VmaAllocator m_allocator{};
+
+        // Staged WriteBuffer() copies, recorded at the start of the next frame
+        struct PendingUpload {
+            VkBuffer staging = VK_NULL_HANDLE;
+            VmaAllocation stagingAllocation = nullptr;
+            VkBuffer destination = VK_NULL_HANDLE;
+            VkDeviceSize offset = 0u;
+            VkDeviceSize size = 0u;
+        };
+        std::mutex m_uploadMutex;
+        std::vector<PendingUpload> m_pendingUploads;    // Guarded by m_uploadMutex
+
+        // Async readbacks: requests from any thread, copied into a ring of READBACK buffers while
+        // recording and delivered once the frame's fence has signaled
+        struct ReadbackRequest {
+            ReadbackId id = 0u;
+            OutputId output = 0u;
+            std::string resource = "";
+            std::shared_ptr<ReadbackCallback> callback;
+            bool continuous = false;
+        };
+        std::mutex m_readbackMutex;
+        std::vector<ReadbackRequest> m_readbackRequests;    // Guarded by m_readbackMutex
+        ReadbackId m_nextReadbackId = 1u;                   // Guarded by m_readbackMutex
+
+        // Buffers are allocated with VMA directly, outside m_buffers and the deletion queue, which
+        // the application thread may use meanwhile
+        struct ReadbackSlot {
+            VkBuffer buffer = VK_NULL_HANDLE;
+            VmaAllocation allocation = {};
+            VkDeviceSize size = 0u;
+            void* mapped = nullptr;
+            bool hostCoherent = false;
+            bool pending = false;                   // Copy recorded, its frame has not completed yet
+            std::atomic<bool> delivering = false;   // Callback running on a job
+            DeletionQueue::FrameNumber frame = 0u;
+            ReadbackImage image {};
+            std::shared_ptr<ReadbackCallback> callback;
+        };
+        static constexpr uint32_t READBACK_RING_SIZE = 8u;
+        std::vector<std::unique_ptr<ReadbackSlot>> m_readbackSlots;  // Render thread only
+
+        std::atomic<uint64_t> m_readbacksCompleted = 0u;
+        std::atomic<uint64_t> m_readbacksDropped = 0u;
+
+        bool m_memoryBudgetSupported = false;
+        MemoryTracker m_memoryTracker;
+
+        mutable std::mutex m_memoryBudgetMutex;
+        MemoryBudgetSettings m_memoryBudgetSettings {};     // Guarded by m_memoryBudgetMutex
+        std::vector<bool> m_heapsNearBudget;                // Render thread only
+
+        DeletionQueue m_deletionQueue;
+
+        // Declared after everything its jobs touch, so its workers are joined first
+        JobSystem m_jobs;
+
+        // Application thread -> render thread
+        FrameMailbox<FrameSnapshot> m_snapshots;
+        const FrameSnapshot* m_frameSnapshot = nullptr;     // Taken by the frame being recorded
+
+        // Application thread -> render thread, run at the start of the next Render()
+        std::mutex m_renderCommandMutex;
+        std::vector<std::move_only_function<void()>> m_renderCommands;     // Guarded by m_renderCommandMutex
+
+        std::jthread m_renderThread;
+        std::exception_ptr m_renderThreadError;
+        std::atomic<bool> m_renderThreadFailed = false;
         
     private:
         uint32_t frameIndex = 0u;
+        DeletionQueue::FrameNumber frameCount = 0u; // Number of frames submitted so far
         const uint32_t MAX_FRAMES_IN_FLIGHT = 3u;
 
     public:
@@ -97,8 +252,9 @@ class Renderer {
         QueueFamilyIndex m_graphicsFamilyIndex;
         QueueFamilyIndex m_transferFamilyIndex;
 
-    private:
-        bool m_frameBufferResized = false;
+    public:
+        using OutputId = uint32_t;
+        static constexpr OutputId PRIMARY_OUTPUT = 0u;
 
     public:
         enum class InitResult : uint8_t {
@@ -111,17 +267,76 @@ class Renderer {
         };
         InitResult Init(const std::string& title);
 
+        // Opens another window presented alongside the primary one. Its swapchain uses the primary
+        // surface format so SWAPCHAIN_FORMAT pipelines stay shared between outputs.
+        enum class AddOutputError : uint8_t {
+            SURFACE_FAILED,
+            PRESENT_UNSUPPORTED,
+            SWAPCHAIN_FAILED
+        };
+        std::expected<OutputId, AddOutputError> AddOutput(const std::string& title, vk::Extent2D size);
+
         void Update();
 
         void Render();
 
         void Shutdown();
 
+    public:
+        // Threaded frame loop: Render() runs on a dedicated render thread, each frame on the newest
+        // published FrameSnapshot, while the calling (main) thread keeps calling Update(), as GLFW
+        // requires, and simulates the next snapshot. Outputs and pipeline modes must be set up
+        // before starting it.
+        //
+        // While it runs, only APIs documented as callable from any thread (WriteBuffer, readbacks,
+        // stats, snapshots) may be called directly. Everything else that touches renderer state goes
+        // through Enqueue(): graph edits, CreateBuffer, DestroyBuffer, DestroyPipeline, Retire,
+        // RequestPipeline.
+        void StartRenderThread();
+        // Rethrows whatever ended the render thread early
+        void StopRenderThread();
+
+        // Runs `command` on the render thread at the start of its next frame, in submission order.
+        // Without a render thread running, runs it right away. Any thread.
+        void Enqueue(std::move_only_function<void()> command);
+
+        // Application thread: fill every field of the returned snapshot, it holds an older one,
+        // then publish it. Waiting for it to be consumed keeps the simulation one frame ahead at most.
+        FrameSnapshot& BeginSnapshot() { return m_snapshots.getWriteSlot(); }
+        void PublishSnapshot() { m_snapshots.Publish(); }
+        bool WaitForSnapshotConsumed(std::chrono::milliseconds timeout) { return m_snapshots.WaitUntilConsumed(timeout); }
+
+        // For passes while recording: the snapshot of the current frame, nullptr until one is published
+        const FrameSnapshot* getFrameSnapshot() const { return m_frameSnapshot; }
+
+        // The renderer's worker pool, sized to the machine, open to the application too
+        JobSystem& getJobSystem() { return m_jobs; }
+
+    public:
+        // Per-heap usage and budget (from VK_EXT_memory_budget when the device has it), and what
+        // this renderer allocated per category. Callable from any thread.
+        MemoryStats getMemoryStats() const;
+
+        // Heaps are checked against their budget once per frame
+        void SetMemoryBudget(const MemoryBudgetSettings& settings);
+
+    public:
+        // Copies mip 0 / layer 0 of a graph image (e.g. "BackBuffer") to the host at the end of
+        // the next recorded frame, or every frame until StopReadback() when `continuous`. The image
+        // needs eTransferSrc usage, single-sampled color formats only. Never waits on the GPU:
+        // captures are dropped while the ring is full. Any thread. Returns INVALID_READBACK_ID
+        // for BackBuffer when the output's surface does not allow eTransferSrc.
+        ReadbackId StartReadback(const std::string& resource, ReadbackCallback callback, bool continuous = false, OutputId output = PRIMARY_OUTPUT);
+        void StopReadback(ReadbackId id);
+        ReadbackStats getReadbackStats() const;
+
     public:
         bool isRunning() const;
 
     private:
-        void InitGLFW(const std::string& title);
+        void InitGLFW();
+        RenderOutput& CreateOutputWindow(const std::string& title, vk::Extent2D size);
+        RenderOutput& getPrimaryOutput() const { return *m_outputs.front(); }
 
         static void FrameBufferSizeCallback(GLFWwindow *window, int width, int height); 
 
@@ -130,7 +345,7 @@ class Renderer {
         void SetupDebugMessenger();
 
     private:
-        void CreateSurface();
+        void CreateSurface(RenderOutput& output);
 
     private:
         void PickPhysicalDevice();
@@ -139,45 +354,144 @@ class Renderer {
         void CreateLogicalDeviceAndQueues();
 
     private:
-        void CreateSwapChain();
-        void reCreateSwapChain();
-        void CleanupSwapChain();
+        void CreateSwapChain(RenderOutput& output, vk::SwapchainKHR oldSwapChain = nullptr);
+        void reCreateSwapChain(RenderOutput& output);
+        void MarkPresented(RenderOutput& output);
+        void CleanupSwapChain(RenderOutput& output);
+
+    private:
+        bool AcquireOutputImage(RenderOutput& output);
+        void UpdateDynamicResolution(RenderOutput& output);
+        void RunRenderCommands();
+        void WriteSnapshotUniforms(const FrameSnapshot& snapshot);
+        void StageBufferWrite(const Buffer& buffer, std::span<const std::byte> data, VkDeviceSize offset = 0u);
+        void RecordOutput(RenderOutput& output);
+        static bool isRecordedByJob(const RenderGraph::RenderPass* node);
+        std::vector<vk::CommandBuffer> RecordPassesInParallel(std::span<RenderGraph::RenderPass* const> nodes);
+        void ExecuteStaticPass(RenderGraph::RenderPass& pass, const vk::raii::CommandBuffer& primary, uint32_t imageIndex);
+        size_t getRecordingKey(const RenderGraph::RenderPass& pass) const;
+        void RecordReadbacks(RenderOutput& output, const vk::raii::CommandBuffer& buffer, RenderGraph::BarrierBatch& barriers);
+        ReadbackSlot* AcquireReadbackSlot(VkDeviceSize size);
+        void AllocateReadbackBuffer(ReadbackSlot& slot, VkDeviceSize size);
+        void DestroyReadbackBuffer(ReadbackSlot& slot);
+        void CollectReadbacks();
+        void PresentOutputs(std::span<RenderOutput* const> outputs);
+
+    private:
+        void CollectRetiredResources();
+        void CheckMemoryBudget();
+        void AllocateBuffer(Buffer& buffer);
+        vk::CommandBuffer RecordUploads();      // Null when there is nothing to upload
+        std::vector<MemoryHeapBudget> getHeapBudgets() const;
+        static MemoryCategory getMemoryCategory(vk::BufferUsageFlags usage);
 
     public:
-        void SetRenderGraph(std::unique_ptr<RenderGraph::RenderGraph> renderGraph);
+        void SetRenderGraph(std::unique_ptr<RenderGraph::RenderGraph> renderGraph, OutputId output = PRIMARY_OUTPUT);
+        // Loads the compiled graph from `compiledGraphPath` instead of compiling when the graph
+        // description still matches, otherwise compiles and rewrites the file
+        void SetRenderGraph(std::unique_ptr<RenderGraph::RenderGraph> renderGraph, const std::filesystem::path& compiledGraphPath, OutputId output = PRIMARY_OUTPUT);
+
+        // The graph can be edited between frames, Render() recompiles it when dirty
+        RenderGraph::RenderGraph& getRenderGraph(OutputId output = PRIMARY_OUTPUT);
+
+        // Moves rasterizer/depth/topology (and extended dynamic state 3 where supported) out of the
+        // pipelines so they are keyed only on shaders, vertex input and attachment formats.
+        // Must be called before SetRenderGraph.
+        void EnableDynamicPipelineState(bool enable = true);
+
+        // Scales the `dynamic` swapchain-relative images of the output's graph to hold a GPU frame time
+        // budget. They are allocated at settings.maxScale and rendered into a sub-rect (renderExtent),
+        // end the graph with an UpscalePass. Call after SetRenderGraph, returns false if the graphics
+        // queue has no timestamps or the UpscalePass blit is not supported: swapchain without
+        // eTransferDst usage or blits, source format without linear-filtered blits.
+        bool EnableDynamicResolution(const DynamicResolution::Settings& settings, OutputId output = PRIMARY_OUTPUT);
+
+        // Compiles pipelines into VK_EXT_shader_object shaders with fully dynamic state instead.
+        // Returns false (and keeps pipelines) if the device does not support it. Must be called before SetRenderGraph.
+        bool EnableShaderObjects(bool enable = true);
+
+        // Builds pipelines from cached VK_EXT_graphics_pipeline_library parts: a new combination only
+        // costs a fast link. With `optimizeInBackground` each one is relinked with link-time
+        // optimization on a worker thread and swapped in once done. Returns false (and keeps
+        // monolithic pipelines) if unsupported or shader objects are on. Must be called before SetRenderGraph.
+        bool EnablePipelineLibraries(bool enable = true, bool optimizeInBackground = true);
+
+        // Returns right away with a Pipeline compiled on background threads, which becomes ready
+        // between frames. Until then its Bind() binds `fallback`, or returns false so the draw can
+        // be skipped. Passes get these for the descriptions they mark `async`.
+        std::shared_ptr<Pipeline> RequestPipeline(const PipelineDescription& desc, std::shared_ptr<const Pipeline> fallback = nullptr);
+
+        struct PipelineCompileStats {
+            uint32_t queued = 0u;       // Waiting for a job thread
+            uint32_t compiling = 0u;    // On a job thread
+            uint32_t pending = 0u;      // Requested and not ready yet, queued and compiling included
+            uint64_t completed = 0u;
+            uint64_t failed = 0u;       // Their Pipelines keep the fallback
+        };
+        PipelineCompileStats getPipelineCompileStats() const;
+
+    private:
+        void AddBackBuffer(RenderOutput& output);
+        void UpdateRenderGraph(RenderGraph::RenderGraph& renderGraph);
+        void PrepareRenderPass(RenderGraph::RenderPass& pass);
+        void ReleaseRenderPass(std::unique_ptr<RenderGraph::RenderPass> pass);
+
+    private:
+        void AllocateGraphImages(RenderGraph::RenderGraph& renderGraph);
+        void AllocateGraphImage(ImageResource& resource);
+        void ReleaseGraphImage(ImageResource& resource);    // Deferred, the resource itself stays
+        void DestroyGraphImages(RenderGraph::RenderGraph& renderGraph);  // Immediate, device must be idle
+
+        void AllocateGraphBuffers(RenderGraph::RenderGraph& renderGraph);
+        void ReleaseGraphBuffer(BufferResource& resource);  // Deferred, the resource itself stays
+        void DestroyGraphBuffers(RenderGraph::RenderGraph& renderGraph);  // Immediate, device must be idle
 
     private:
-        void CreateCommandPool();
-        void CreateCommandBuffers();
+        void CreateCommandPools();
 
     private:
         void CreateSyncObjects();
+        void CreateOutputSyncObjects(RenderOutput& output);
 
     private:
         void CreateAllocator();
 
     private:
-        std::vector<vk::PipelineShaderStageCreateInfo> getShaderStages(GraphicsShader& shader) const;
-        vk::raii::PipelineLayout getPipelineLayout(PipelineDescription desc) const;
-        void CreateVulkanPipeline(PipelineDescription desc, vk::raii::Pipeline& pipeline, vk::raii::PipelineLayout& layout) const;
+        // The stages point at desc's specialization constants, desc must outlive them
+        std::shared_ptr<const ByteArray> getShaderCode(ShaderModule& shaderModule) const;
+        vk::ShaderModule getOrCreateShaderModule(ShaderModule& shaderModule) const;
+        std::vector<vk::PipelineShaderStageCreateInfo> getShaderStages(PipelineDescription& desc) const;
+        std::shared_ptr<vk::raii::PipelineLayout> getPipelineLayout(const PipelineDescription& desc) const;
+        void CreateVulkanPipeline(PipelineDescription desc, vk::raii::Pipeline& pipeline, std::shared_ptr<vk::raii::PipelineLayout>& layout) const;
+        void CreateShaderObjects(const PipelineDescription& desc, PipelineHandle& handle) const;
+        std::shared_ptr<Pipeline> getOrCreatePipeline(const PipelineDescription& desc);
+        void CreateComputePipeline(ComputePipelineDescription desc, PipelineHandle& handle) const;
+
+        template<PipelineLibraryPart part>
+        std::shared_ptr<vk::raii::Pipeline> getOrCreateLibraryPart(PipelineDescription desc, const vk::raii::PipelineLayout& layout);
+        void CreateLinkedPipeline(const PipelineDescription& desc, const std::shared_ptr<PipelineHandle>& handle);
+        void CollectOptimizedPipelines();
+        void ResetPipelineRegistries();
+        std::shared_ptr<PipelineHandle> CreatePipelineHandle(const PipelineDescription& desc);
+
+        void CompilePipeline(const std::shared_ptr<PipelineCompileJob>& job);
+        void PublishCompiledPipelines();
+        void WaitForBackgroundJobs();
+
+        // Creates the handles of every pipeline `passes` need that is not registered yet, in parallel
+        void PrecompilePipelines(std::span<const std::unique_ptr<RenderGraph::RenderPass>> passes);
+        std::shared_ptr<Pipeline> getOrCreatePipeline(const ComputePipelineDescription& desc);
 
     private:
         std::vector<Extensions::Extension> getRequiredExtensions() const;
 
     public:
+        // GPU_ONLY memory
         template<Buffer_T T, typename... Args>
         std::shared_ptr<T> CreateBuffer(Args&&... args) {
             std::shared_ptr<T> buffer = std::make_shared<T>(std::forward<Args>(args)...);
 
-            vk::BufferCreateInfo bufferInfo {
-                .size = buffer->size,
-                .usage = buffer->usage,
-            };
-            
-            VmaAllocationCreateInfo allocInfo{};
-            allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
-
-            vmaCreateBuffer(m_allocator, &*bufferInfo, &allocInfo, &buffer->buffer, &buffer->allocation, nullptr);
+            AllocateBuffer(*buffer);
 
             m_buffers.push_back(buffer);
             return buffer;
@@ -185,10 +499,41 @@ class Renderer {
 
         template<Buffer_T T>
         std::shared_ptr<T> CreateBuffer(const BufferDescription& desc) {
-            return CreateBuffer<T>(desc.name, desc.size);
+            std::shared_ptr<T> buffer = std::make_shared<T>(desc.name, desc.size);
+            buffer->memory = desc.memory;
+
+            AllocateBuffer(*buffer);
+
+            m_buffers.push_back(buffer);
+            return buffer;
+        }
+
+        // Mapped buffers are written in place, others through a staging copy ordered before the
+        // next frame's passes. Either way, data a frame in flight may still read must not be
+        // overwritten: per-frame data needs one region per frame in flight. Any thread.
+        void WriteBuffer(const Buffer& buffer, std::span<const std::byte> data, VkDeviceSize offset = 0u);
+
+        // Mapped buffers (READBACK), once the frame that wrote them has completed
+        void ReadBuffer(const Buffer& buffer, std::span<std::byte> data, VkDeviceSize offset = 0u) const;
+
+        template<typename T>
+        requires std::is_trivially_copyable_v<T>
+        void UpdateUniform(const UniformBuffer& buffer, const T& data) {
+            WriteBuffer(buffer, std::as_bytes(std::span(&data, 1u)));
         }
 
+    public:
+        // Deferred destruction: freed once every frame that may still reference them has completed
+        void DestroyBuffer(const std::shared_ptr<Buffer>& buffer);
+        void DestroyBuffers(std::span<const std::shared_ptr<Buffer>> buffers);
+        void DestroyPipeline(const std::shared_ptr<Pipeline>& pipeline);
+        void DestroyImage(VkImage image, VmaAllocation allocation);
+
+        // Hands over any RAII object (image views, samplers, ...) for deferred destruction
         template<typename T>
-        void UpdateUniform(const UniformBuffer& buffer, const T& data) const;
+        requires (!std::is_lvalue_reference_v<T>)
+        void Retire(T&& object) {
+            m_deletionQueue.Retire(frameCount, std::move(object));
+        }
 
 };
@@ -3,6 +3,9 @@
 #include <filesystem>
 #include <optional>
 #include <utility>
+#include <memory>
+#include <vector>
+#include <cstddef>
 
 namespace vk {
     namespace raii {
@@ -17,15 +20,22 @@ class ShaderModule {
         vk::raii::ShaderModule module = VK_NULL_HANDLE;
         std::filesystem::path path {};
 
+        // SPIR-V read on first use, kept for shader objects, which are created from the code itself
+        std::shared_ptr<const std::vector<std::byte>> code;
+
     public:
         ShaderModule() = default;
         ShaderModule(const std::filesystem::path& path) : path(path) {}
+
+    public:
+        const std::filesystem::path& getPath() const { return path; }
 };
 
 enum class ShaderStageType {
     VERTEX = 0,
     FRAGMENT,
-    GEOMETRY 
+    GEOMETRY,
+    COMPUTE
 };
 
 template<ShaderStageType shaderStage>
@@ -34,11 +44,19 @@ struct ShaderStage {
     std::string entry = "";
 
     constexpr static ShaderStageType getStageType() { return shaderStage; }
+
+    // Stages are the same if they run the same entry of the same SPIR-V file
+    bool operator==(const ShaderStage& other) const {
+        if (entry != other.entry) return false;
+        if (module == other.module) return true;
+        return module && other.module && module->getPath() == other.module->getPath();
+    }
 };
 
 using VertexStage = ShaderStage<ShaderStageType::VERTEX>;
 using FragmentStage = ShaderStage<ShaderStageType::FRAGMENT>;
 using GeometryStage = ShaderStage<ShaderStageType::GEOMETRY>;
+using ComputeStage = ShaderStage<ShaderStageType::COMPUTE>;
 
 enum class ShaderUsage {
     GRAPHICS = 0,
@@ -69,12 +87,30 @@ class Shader<ShaderUsage::GRAPHICS> {
 
         Shader(const VertexStage& vertex, const FragmentStage& fragment, const GeometryStage& geometry) 
             : vertexStage(vertex), fragmentStage(fragment), geometryStage(geometry) {}
+
+    public:
+        const VertexStage& getVertexStage() const { return vertexStage; }
+        const FragmentStage& getFragmentStage() const { return fragmentStage; }
+        const std::optional<GeometryStage>& getGeometryStage() const { return geometryStage; }
+
+        bool operator==(const Shader& other) const = default;
 };
 
 template<>
 class Shader<ShaderUsage::COMPUTE> {
+    friend class Renderer;
     private:
-        ShaderModule computeShader{}; 
+        ComputeStage computeStage;
+
+    public:
+        Shader() = default;
+
+        Shader(const ComputeStage& compute) : computeStage(compute) {}
+
+    public:
+        const ComputeStage& getComputeStage() const { return computeStage; }
+
+        bool operator==(const Shader& other) const = default;
 };
 
 inline GraphicsShader make_graphicsShader(const std::filesystem::path& modulePath, std::string vertEntry = "vertMain", std::string fragEntry = "fragMain") {
@@ -96,10 +132,14 @@ inline GraphicsShader make_graphicsShader(const std::filesystem::path& vertPath,
     return GraphicsShader(VertexStage{ .module = vertModule, .entry =vertEntry }, FragmentStage{ .module = fragModule, .entry = fragEntry } );
 }
 
+inline ComputeShader make_computeShader(const std::filesystem::path& modulePath, std::string entry = "compMain") {
+    return ComputeShader(ComputeStage{ .module = std::make_shared<ShaderModule>(modulePath), .entry = entry });
+}
+
 template<ShaderUsage U, typename... Args>
 inline Shader<U> make_shader(Args&&... args) {
     if constexpr (U == ShaderUsage::GRAPHICS) return make_graphicsShader(std::forward<Args>(args)...);
-    if constexpr (U == ShaderUsage::COMPUTE) return {}; // TODO
+    if constexpr (U == ShaderUsage::COMPUTE) return make_computeShader(std::forward<Args>(args)...);
 
     return {};
 }
@@ -29,6 +29,8 @@ struct VertexBindingDescription {
     uint32_t binding = 0;
     uint32_t stride = 0;
     VertexInputRate inputRate = VertexInputRate::PER_VERTEX;
+
+    bool operator==(const VertexBindingDescription&) const = default;
 };
 
 struct VertexAttributeDescription {
@@ -36,9 +38,13 @@ struct VertexAttributeDescription {
     uint32_t binding = 0;
     VertexAttributeType type = VertexAttributeType::FLOAT;
     uint32_t offset = 0;
+
+    bool operator==(const VertexAttributeDescription&) const = default;
 };
 
 struct VertexInfo {
     std::vector<VertexBindingDescription> bindings;
     std::vector<VertexAttributeDescription> attributes;
+
+    bool operator==(const VertexInfo&) const = default;
 };
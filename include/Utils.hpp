@@ -1,5 +1,6 @@
 #pragma once
 
+#include <span>
 #include <ranges>
 
 #ifndef NDEBUG
@@ -19,6 +20,11 @@ bool isAllPresent(const std::vector<A>& a, const std::vector<B>& b) {
                 });
 }
 
+template<typename T>
+inline void hashCombine(size_t& seed, const T& value) {
+    seed ^= std::hash<T>{}(value) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+}
+
 using ByteArray = std::vector<std::byte>;
 
 enum class ReadFileError {
@@ -40,3 +46,4 @@ inline std::string to_string(const ReadFileError& err) {
 
 std::expected<ByteArray, ReadFileError> readRawFile(const std::filesystem::path& filePath);
 ByteArray readRawFileFast(const std::filesystem::path& filePath);
+bool writeRawFile(const std::filesystem::path& filePath, std::span<const std::byte> data);
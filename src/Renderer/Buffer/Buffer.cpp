@@ -6,6 +6,7 @@ vk::BufferUsageFlags Buffer::getUsageFlags(BufferUsage usage) {
         case BufferUsage::VERTEX_BUFFER: return vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst;
         case BufferUsage::TRANSFER_BUFFER: return vk::BufferUsageFlagBits::eTransferSrc;
         case BufferUsage::UNIFORM_BUFFER: return vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eTransferDst;
+        case BufferUsage::STORAGE_BUFFER: return vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eTransferSrc;
     }
 
     return {};
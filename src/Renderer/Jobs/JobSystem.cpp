@@ -0,0 +1,233 @@
+#include "pch.hpp"
+#include "Renderer/Jobs/JobSystem.hpp"
+
+#include "Utils.hpp"
+
+// Which queue the current thread owns
+static thread_local const JobSystem* t_jobSystem = nullptr;
+static thread_local uint32_t t_workerIndex = 0u;
+
+JobSystem::JobSystem()
+    : JobSystem(std::max(std::thread::hardware_concurrency(), 2u) - 1u) {}
+
+JobSystem::JobSystem(uint32_t workerCount) : m_mainThread(std::this_thread::get_id()) {
+    // At least one worker: jobs nobody waits for must still run
+    workerCount = std::max(workerCount, 1u);
+
+    for (uint32_t i = 0; i <= workerCount; ++i) {
+        m_queues.push_back(std::make_unique<TaskQueue>());
+    }
+
+    m_workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        m_workers.emplace_back(
+                [this, i] (std::stop_token stopToken) {
+                    WorkerLoop(i, stopToken);
+                });
+    }
+}
+
+// Queued jobs are dropped, running ones finish first
+JobSystem::~JobSystem() {
+    for (std::jthread& worker : m_workers) {
+        worker.request_stop();
+    }
+    m_workers.clear();
+}
+
+void JobSystem::Submit(Job job, JobCounter* counter) {
+    if (counter) counter->m_value.fetch_add(1u, std::memory_order_relaxed);
+
+    Push(Task{ std::move(job), counter });
+}
+
+void JobSystem::Submit(Job job, JobCounter& dependency, JobCounter* counter) {
+    if (counter) counter->m_value.fetch_add(1u, std::memory_order_relaxed);
+
+    Job start = [this, job = std::move(job), counter] () mutable {
+        Push(Task{ std::move(job), counter });
+    };
+
+    {
+        // Finish() takes the continuations under the same lock once the value reaches zero
+        std::scoped_lock lock(dependency.m_mutex);
+        if (!dependency.isDone()) {
+            dependency.m_continuations.push_back(std::move(start));
+            return;
+        }
+    }
+
+    start();
+}
+
+void JobSystem::SubmitBackground(Job job, JobCounter* counter) {
+    if (counter) counter->m_value.fetch_add(1u, std::memory_order_relaxed);
+
+    {
+        std::scoped_lock lock(m_backgroundQueue.mutex);
+        m_backgroundQueue.tasks.push_back(Task{ std::move(job), counter });
+    }
+    Notify();
+}
+
+void JobSystem::SubmitMainThread(Job job, JobCounter* counter) {
+    if (counter) counter->m_value.fetch_add(1u, std::memory_order_relaxed);
+
+    std::scoped_lock lock(m_mainThreadQueue.mutex);
+    m_mainThreadQueue.tasks.push_back(Task{ std::move(job), counter });
+}
+
+void JobSystem::PumpMainThread() {
+    assert(isMainThread() && "Main thread jobs must run on the thread that created the job system");
+
+    std::deque<Task> tasks;
+    {
+        std::scoped_lock lock(m_mainThreadQueue.mutex);
+        tasks.swap(m_mainThreadQueue.tasks);
+    }
+
+    for (Task& task : tasks) {
+        Run(task);
+    }
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+    const uint32_t queueIndex = getQueueIndex();
+
+    while (!counter.isDone()) {
+        if (isMainThread()) PumpMainThread();
+
+        if (!TryRun(queueIndex)) {
+            std::this_thread::yield();
+        }
+    }
+
+    std::exception_ptr error;
+    {
+        std::scoped_lock lock(counter.m_mutex);
+        error = std::exchange(counter.m_error, nullptr);
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+void JobSystem::Push(Task&& task) {
+    TaskQueue& queue = *m_queues[getQueueIndex()];
+    {
+        std::scoped_lock lock(queue.mutex);
+        queue.tasks.push_back(std::move(task));
+    }
+    Notify();
+}
+
+void JobSystem::Notify() {
+    m_queuedTasks.fetch_add(1u, std::memory_order_release);
+
+    // Taken so a worker between checking the count and sleeping cannot miss the notification
+    { std::scoped_lock lock(m_sleepMutex); }
+    m_wake.notify_one();
+}
+
+// Own queue first (newest job, its data is likely still in cache), then the oldest job of the others
+bool JobSystem::TryRun(uint32_t queueIndex) {
+    const uint32_t queueCount = static_cast<uint32_t>(m_queues.size());
+    const bool isWorker = queueIndex + 1u < queueCount;
+
+    std::optional<Task> task;
+    for (uint32_t i = 0; i < queueCount && !task; ++i) {
+        TaskQueue& queue = *m_queues[(queueIndex + i) % queueCount];
+
+        std::scoped_lock lock(queue.mutex);
+        if (queue.tasks.empty()) continue;
+
+        if (i == 0u && isWorker) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+        else {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+    }
+    if (!task) return false;
+
+    m_queuedTasks.fetch_sub(1u, std::memory_order_relaxed);
+    Run(*task);
+
+    return true;
+}
+
+bool JobSystem::TryRunBackground() {
+    std::optional<Task> task;
+    {
+        std::scoped_lock lock(m_backgroundQueue.mutex);
+        if (m_backgroundQueue.tasks.empty()) return false;
+
+        task = std::move(m_backgroundQueue.tasks.front());
+        m_backgroundQueue.tasks.pop_front();
+    }
+
+    m_queuedTasks.fetch_sub(1u, std::memory_order_relaxed);
+    Run(*task);
+
+    return true;
+}
+
+void JobSystem::Run(Task& task) {
+    try {
+        task.job();
+    }
+    catch (...) {
+        if (task.counter) {
+            std::scoped_lock lock(task.counter->m_mutex);
+            if (!task.counter->m_error) task.counter->m_error = std::current_exception();
+        }
+        else {
+            try {
+                throw;
+            }
+            catch (const std::exception& e) {
+                DEBUG_PRINT(std::string("Job failed: ") + e.what());
+            }
+            catch (...) {
+                DEBUG_PRINT("Job failed");
+            }
+        }
+    }
+
+    Finish(task.counter);
+}
+
+void JobSystem::Finish(JobCounter* counter) {
+    if (!counter) return;
+    if (counter->m_value.fetch_sub(1u, std::memory_order_acq_rel) != 1u) return;
+
+    std::vector<Job> continuations;
+    {
+        std::scoped_lock lock(counter->m_mutex);
+        continuations.swap(counter->m_continuations);
+    }
+
+    for (Job& continuation : continuations) {
+        continuation();
+    }
+}
+
+void JobSystem::WorkerLoop(uint32_t index, std::stop_token stopToken) {
+    t_jobSystem = this;
+    t_workerIndex = index;
+
+    while (!stopToken.stop_requested()) {
+        if (TryRun(index) || TryRunBackground()) continue;
+
+        std::unique_lock lock(m_sleepMutex);
+        m_wake.wait(lock, stopToken,
+                [this] {
+                    return m_queuedTasks.load(std::memory_order_acquire) > 0u;
+                });
+    }
+}
+
+// Threads that are not workers share the last queue
+uint32_t JobSystem::getQueueIndex() const {
+    return t_jobSystem == this ? t_workerIndex : static_cast<uint32_t>(m_queues.size()) - 1u;
+}
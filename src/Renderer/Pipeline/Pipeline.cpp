@@ -0,0 +1,222 @@
+#include "pch.hpp"
+#include "Renderer/Pipeline/Pipeline.hpp"
+#include "Renderer/Buffer/Buffer.hpp"
+
+bool Pipeline::Bind(const vk::raii::CommandBuffer& cmdBuffer) const {
+    if (!handle) {
+        return fallback && fallback->Bind(cmdBuffer);
+    }
+
+    if (handle->isShaderObject()) {
+        cmdBuffer.bindShadersEXT(handle->shaderStages, handle->shaderHandles);
+    }
+    else {
+        cmdBuffer.bindPipeline(handle->bindPoint, *handle->pipeline);
+    }
+
+    // Compute binds do not touch graphics state
+    if (!stateCache || handle->bindPoint != vk::PipelineBindPoint::eGraphics) return true;
+
+    if (dynamicState) {
+        stateCache->Apply(cmdBuffer, dynamicState.value());
+    }
+    else {
+        // Binding a pipeline with baked state invalidates whatever was set dynamically
+        stateCache->Invalidate();
+    }
+
+    return true;
+}
+
+void Pipeline::SetViewport(const vk::raii::CommandBuffer& cmdBuffer, const vk::Viewport& viewport) const {
+    // Whichever pipeline Bind() bound decides the variant
+    if (!handle) {
+        if (fallback) fallback->SetViewport(cmdBuffer, viewport);
+        return;
+    }
+
+    if (handle->isShaderObject()) cmdBuffer.setViewportWithCount(viewport);
+    else cmdBuffer.setViewport(0, viewport);
+}
+
+void Pipeline::SetScissor(const vk::raii::CommandBuffer& cmdBuffer, const vk::Rect2D& scissor) const {
+    if (!handle) {
+        if (fallback) fallback->SetScissor(cmdBuffer, scissor);
+        return;
+    }
+
+    if (handle->isShaderObject()) cmdBuffer.setScissorWithCount(scissor);
+    else cmdBuffer.setScissor(0, scissor);
+}
+
+static void pushBuffer(const vk::raii::CommandBuffer& cmdBuffer, const PipelineHandle& handle, uint32_t binding,
+        const Buffer& buffer, vk::DescriptorType type) {
+    vk::DescriptorBufferInfo bufferInfo {
+        .buffer = buffer.getHandle(),
+        .offset = 0u,
+        .range = vk::WholeSize
+    };
+
+    cmdBuffer.pushDescriptorSetKHR(handle.bindPoint, **handle.pipelineLayout, 0u,
+            vk::WriteDescriptorSet {
+                .dstBinding = binding,
+                .descriptorCount = 1u,
+                .descriptorType = type,
+                .pBufferInfo = &bufferInfo
+            });
+}
+
+// Descriptors and dispatches go to whichever pipeline Bind() bound, like push constants
+void Pipeline::BindStorageImage(const vk::raii::CommandBuffer& cmdBuffer, uint32_t binding, vk::ImageView view) const {
+    if (!handle) {
+        if (fallback) fallback->BindStorageImage(cmdBuffer, binding, view);
+        return;
+    }
+
+    vk::DescriptorImageInfo imageInfo {
+        .imageView = view,
+        .imageLayout = vk::ImageLayout::eGeneral
+    };
+
+    cmdBuffer.pushDescriptorSetKHR(handle->bindPoint, **handle->pipelineLayout, 0u,
+            vk::WriteDescriptorSet {
+                .dstBinding = binding,
+                .descriptorCount = 1u,
+                .descriptorType = vk::DescriptorType::eStorageImage,
+                .pImageInfo = &imageInfo
+            });
+}
+
+void Pipeline::BindStorageBuffer(const vk::raii::CommandBuffer& cmdBuffer, uint32_t binding, const Buffer& buffer) const {
+    if (!handle) {
+        if (fallback) fallback->BindStorageBuffer(cmdBuffer, binding, buffer);
+        return;
+    }
+
+    pushBuffer(cmdBuffer, *handle, binding, buffer, vk::DescriptorType::eStorageBuffer);
+}
+
+void Pipeline::BindUniformBuffer(const vk::raii::CommandBuffer& cmdBuffer, uint32_t binding, const Buffer& buffer) const {
+    if (!handle) {
+        if (fallback) fallback->BindUniformBuffer(cmdBuffer, binding, buffer);
+        return;
+    }
+
+    pushBuffer(cmdBuffer, *handle, binding, buffer, vk::DescriptorType::eUniformBuffer);
+}
+
+void Pipeline::PushConstantData(const vk::raii::CommandBuffer& cmdBuffer, vk::ShaderStageFlags stages, uint32_t offset, uint32_t size, const void* data) const {
+    // Pushed to the layout Bind() bound
+    if (!handle) {
+        if (fallback) fallback->PushConstantData(cmdBuffer, stages, offset, size, data);
+        return;
+    }
+
+    assert(offset % 4u == 0u && "Push constant offsets must be a multiple of 4");
+
+    cmdBuffer.pushConstants<std::byte>(**handle->pipelineLayout, stages, offset,
+            vk::ArrayProxy<const std::byte>(size, static_cast<const std::byte*>(data)));
+}
+
+void Pipeline::Dispatch(const vk::raii::CommandBuffer& cmdBuffer, vk::Extent2D extent, vk::Extent2D localSize) const {
+    // Nothing was bound without a fallback either: no dispatch
+    if (!handle) {
+        if (fallback) fallback->Dispatch(cmdBuffer, extent, localSize);
+        return;
+    }
+
+    assert(localSize.width > 0u && localSize.height > 0u && "Dispatch needs a non-zero local size");
+    if (localSize.width == 0u || localSize.height == 0u) return;
+
+    assert(handle->bindPoint == vk::PipelineBindPoint::eCompute && "Dispatch needs a compute pipeline");
+
+    cmdBuffer.dispatch((extent.width + localSize.width - 1u) / localSize.width,
+                       (extent.height + localSize.height - 1u) / localSize.height,
+                       1u);
+}
+
+DynamicStateCache::Tracked& DynamicStateCache::getTracked() {
+    static thread_local Tracked tracked;
+    return tracked;
+}
+
+void DynamicStateCache::Invalidate() {
+    Tracked& tracked = getTracked();
+    tracked.commandBuffer = nullptr;
+    tracked.current.reset();
+}
+
+void DynamicStateCache::Apply(const vk::raii::CommandBuffer& cmd, const DynamicPipelineState& state) {
+    Tracked& tracked = getTracked();
+    if (tracked.owner != this || tracked.commandBuffer != *cmd) {
+        tracked.owner = this;
+        tracked.commandBuffer = *cmd;
+        tracked.current.reset();
+    }
+
+    const bool force = !tracked.current.has_value();
+    const DynamicPipelineState& last = force ? state : tracked.current.value();
+
+    if (force || last.cullMode != state.cullMode) cmd.setCullMode(state.cullMode);
+    if (force || last.frontFace != state.frontFace) cmd.setFrontFace(state.frontFace);
+    if (force || last.topology != state.topology) cmd.setPrimitiveTopology(state.topology);
+    if (force || last.rasterizerDiscardEnable != state.rasterizerDiscardEnable) cmd.setRasterizerDiscardEnable(state.rasterizerDiscardEnable);
+    if (force || last.depthTestEnable != state.depthTestEnable) cmd.setDepthTestEnable(state.depthTestEnable);
+    if (force || last.depthWriteEnable != state.depthWriteEnable) cmd.setDepthWriteEnable(state.depthWriteEnable);
+    if (force || last.depthCompareOp != state.depthCompareOp) cmd.setDepthCompareOp(state.depthCompareOp);
+
+    if (m_support.polygonMode && (force || last.polygonMode != state.polygonMode)) {
+        cmd.setPolygonModeEXT(state.polygonMode);
+    }
+    if (m_support.depthClampEnable && (force || last.depthClampEnable != state.depthClampEnable)) {
+        cmd.setDepthClampEnableEXT(state.depthClampEnable);
+    }
+    if (m_support.rasterizationSamples && (force || last.rasterizationSamples != state.rasterizationSamples)) {
+        cmd.setRasterizationSamplesEXT(state.rasterizationSamples);
+    }
+    if (m_support.colorBlend && state.colorAttachmentCount > 0u) {
+        if (force || last.colorBlendEnable != state.colorBlendEnable || last.colorAttachmentCount != state.colorAttachmentCount) {
+            std::vector<vk::Bool32> enables(state.colorAttachmentCount, state.colorBlendEnable ? vk::True : vk::False);
+            cmd.setColorBlendEnableEXT(0u, enables);
+        }
+        if (force || last.colorBlendEquation != state.colorBlendEquation || last.colorAttachmentCount != state.colorAttachmentCount) {
+            std::vector<vk::ColorBlendEquationEXT> equations(state.colorAttachmentCount, state.colorBlendEquation);
+            cmd.setColorBlendEquationEXT(0u, equations);
+        }
+    }
+
+    if (m_support.shaderObject) {
+        ApplyShaderObjectState(cmd, state, force ? nullptr : &last);
+    }
+
+    tracked.current = state;
+}
+
+void DynamicStateCache::ApplyShaderObjectState(const vk::raii::CommandBuffer& cmd, const DynamicPipelineState& state, const DynamicPipelineState* last) {
+    if (!last || last->vertexBindings != state.vertexBindings || last->vertexAttributes != state.vertexAttributes) {
+        cmd.setVertexInputEXT(state.vertexBindings, state.vertexAttributes);
+    }
+
+    if (!last || last->colorAttachmentCount != state.colorAttachmentCount) {
+        if (state.colorAttachmentCount > 0u) {
+            std::vector<vk::ColorComponentFlags> writeMasks(state.colorAttachmentCount,
+                    vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG | vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA);
+            cmd.setColorWriteMaskEXT(0u, writeMasks);
+        }
+    }
+
+    if (!last || last->rasterizationSamples != state.rasterizationSamples) {
+        std::vector<vk::SampleMask> sampleMask((static_cast<uint32_t>(state.rasterizationSamples) + 31u) / 32u, ~0u);
+        cmd.setSampleMaskEXT(state.rasterizationSamples, sampleMask);
+    }
+
+    if (last) return;
+
+    // Everything PipelineDescription cannot express, set once per command buffer
+    cmd.setPrimitiveRestartEnable(vk::False);
+    cmd.setDepthBiasEnable(vk::False);
+    cmd.setDepthBoundsTestEnable(vk::False);
+    cmd.setStencilTestEnable(vk::False);
+    cmd.setAlphaToCoverageEnableEXT(vk::False);
+    cmd.setLineWidth(1.0f);
+}
@@ -0,0 +1,221 @@
+#include "pch.hpp"
+#include "Renderer/Pipeline/PipelineDescription.hpp"
+
+#include "Utils.hpp"
+
+template<ShaderStageType stage>
+static void hashStage(size_t& seed, const ShaderStage<stage>& shaderStage) {
+    hashCombine(seed, shaderStage.entry);
+    if (shaderStage.module) {
+        hashCombine(seed, std::filesystem::hash_value(shaderStage.module->getPath()));
+    }
+}
+
+static PrimitiveTopology getTopologyClass(PrimitiveTopology topology) {
+    switch (topology) {
+        case PrimitiveTopology::TRIANGLE_LIST:
+        case PrimitiveTopology::TRIANGLE_STRIP: return PrimitiveTopology::TRIANGLE_LIST;
+        case PrimitiveTopology::LINE_LIST:
+        case PrimitiveTopology::LINE_STRIP: return PrimitiveTopology::LINE_LIST;
+        case PrimitiveTopology::POINT_LIST: return PrimitiveTopology::POINT_LIST;
+    }
+
+    return topology;
+}
+
+static void hashPushConstants(size_t& seed, const std::vector<PushConstantRange>& ranges) {
+    for (const PushConstantRange& range : ranges) {
+        hashCombine(seed, static_cast<VkShaderStageFlags>(range.stages));
+        hashCombine(seed, range.offset);
+        hashCombine(seed, range.size);
+    }
+}
+
+size_t PushConstantRangesHash::operator()(const std::vector<PushConstantRange>& ranges) const {
+    size_t seed = 0;
+    hashPushConstants(seed, ranges);
+    return seed;
+}
+
+// The hash and equality below are split along the graphics pipeline library parts, each part
+// only covers the fields that end up in it
+
+static void hashVertexInput(size_t& seed, const PipelineDescription& desc, const DynamicStateSupport& dynamic) {
+    for (const VertexBindingDescription& binding : desc.vertexInfo.bindings) {
+        hashCombine(seed, binding.binding);
+        hashCombine(seed, binding.stride);
+        hashCombine(seed, binding.inputRate);
+    }
+    for (const VertexAttributeDescription& attribute : desc.vertexInfo.attributes) {
+        hashCombine(seed, attribute.location);
+        hashCombine(seed, attribute.binding);
+        hashCombine(seed, attribute.type);
+        hashCombine(seed, attribute.offset);
+    }
+
+    // Dynamic topology may only change within the same class
+    hashCombine(seed, dynamic.enabled ? getTopologyClass(desc.topology) : desc.topology);
+}
+
+static void hashPreRasterization(size_t& seed, const PipelineDescription& desc, const DynamicStateSupport& dynamic) {
+    hashStage(seed, desc.shader.getVertexStage());
+    desc.vertexConstants.Hash(seed);
+    if (desc.shader.getGeometryStage()) {
+        hashStage(seed, desc.shader.getGeometryStage().value());
+        desc.geometryConstants.Hash(seed);
+    }
+    hashPushConstants(seed, desc.pushConstants);
+
+    if (!dynamic.depthClampEnable) hashCombine(seed, desc.rasterizer.depthClampEnable);
+    if (!dynamic.polygonMode) hashCombine(seed, desc.rasterizer.polygonMode);
+    if (!dynamic.enabled) {
+        hashCombine(seed, desc.rasterizer.discardEnable);
+        hashCombine(seed, desc.rasterizer.faceCulling.cullFace);
+        hashCombine(seed, desc.rasterizer.faceCulling.frontFace);
+    }
+}
+
+// A dynamic sample count still bakes sample shading, enabled for any count but ONE
+static void hashSampleCount(size_t& seed, const PipelineDescription& desc, const DynamicStateSupport& dynamic) {
+    if (dynamic.rasterizationSamples) hashCombine(seed, desc.sampleCount != SampleCount::ONE);
+    else hashCombine(seed, desc.sampleCount);
+}
+
+static bool equalSampleCount(const PipelineDescription& a, const PipelineDescription& b, const DynamicStateSupport& dynamic) {
+    return dynamic.rasterizationSamples
+        ? (a.sampleCount != SampleCount::ONE) == (b.sampleCount != SampleCount::ONE)
+        : a.sampleCount == b.sampleCount;
+}
+
+static void hashFragmentShader(size_t& seed, const PipelineDescription& desc, const DynamicStateSupport& dynamic) {
+    hashStage(seed, desc.shader.getFragmentStage());
+    desc.fragmentConstants.Hash(seed);
+    hashPushConstants(seed, desc.pushConstants);
+
+    if (!dynamic.enabled) {
+        hashCombine(seed, desc.depthTestEnabled);
+        hashCombine(seed, desc.depthWriteEnabled);
+        hashCombine(seed, desc.depthCompare);
+    }
+    hashSampleCount(seed, desc, dynamic);
+}
+
+static void hashFragmentOutput(size_t& seed, const PipelineDescription& desc, const DynamicStateSupport& dynamic) {
+    hashSampleCount(seed, desc, dynamic);
+    if (!dynamic.colorBlend) hashCombine(seed, desc.colorBlend);
+
+    for (const ColorAttachmentFormat& format : desc.colorAttachments) {
+        hashCombine(seed, format);
+    }
+}
+
+static bool equalVertexInput(const PipelineDescription& a, const PipelineDescription& b, const DynamicStateSupport& dynamic) {
+    if (a.vertexInfo != b.vertexInfo) return false;
+
+    return dynamic.enabled
+        ? getTopologyClass(a.topology) == getTopologyClass(b.topology)
+        : a.topology == b.topology;
+}
+
+static bool equalPreRasterization(const PipelineDescription& a, const PipelineDescription& b, const DynamicStateSupport& dynamic) {
+    if (!(a.shader.getVertexStage() == b.shader.getVertexStage() && a.shader.getGeometryStage() == b.shader.getGeometryStage())) {
+        return false;
+    }
+    if (a.vertexConstants != b.vertexConstants) return false;
+    if (a.shader.getGeometryStage() && a.geometryConstants != b.geometryConstants) return false;
+    if (a.pushConstants != b.pushConstants) return false;
+
+    if (!dynamic.depthClampEnable && a.rasterizer.depthClampEnable != b.rasterizer.depthClampEnable) return false;
+    if (!dynamic.polygonMode && a.rasterizer.polygonMode != b.rasterizer.polygonMode) return false;
+    if (!dynamic.enabled) {
+        if (a.rasterizer.discardEnable != b.rasterizer.discardEnable) return false;
+        if (a.rasterizer.faceCulling != b.rasterizer.faceCulling) return false;
+    }
+
+    return true;
+}
+
+static bool equalFragmentShader(const PipelineDescription& a, const PipelineDescription& b, const DynamicStateSupport& dynamic) {
+    if (!(a.shader.getFragmentStage() == b.shader.getFragmentStage()) || a.fragmentConstants != b.fragmentConstants) {
+        return false;
+    }
+    if (a.pushConstants != b.pushConstants) return false;
+
+    if (!dynamic.enabled) {
+        if (a.depthTestEnabled != b.depthTestEnabled) return false;
+        if (a.depthWriteEnabled != b.depthWriteEnabled) return false;
+        if (a.depthCompare != b.depthCompare) return false;
+    }
+    if (!equalSampleCount(a, b, dynamic)) return false;
+
+    return true;
+}
+
+static bool equalFragmentOutput(const PipelineDescription& a, const PipelineDescription& b, const DynamicStateSupport& dynamic) {
+    if (a.colorAttachments != b.colorAttachments) return false;
+    if (!equalSampleCount(a, b, dynamic)) return false;
+    if (!dynamic.colorBlend && a.colorBlend != b.colorBlend) return false;
+
+    return true;
+}
+
+size_t PipelineDescriptionHash::operator()(const PipelineDescription& desc) const {
+    size_t seed = 0;
+
+    hashVertexInput(seed, desc, dynamicStates);
+    hashPreRasterization(seed, desc, dynamicStates);
+    hashFragmentShader(seed, desc, dynamicStates);
+    hashFragmentOutput(seed, desc, dynamicStates);
+
+    return seed;
+}
+
+bool PipelineDescriptionEqual::operator()(const PipelineDescription& a, const PipelineDescription& b) const {
+    return equalVertexInput(a, b, dynamicStates)
+        && equalPreRasterization(a, b, dynamicStates)
+        && equalFragmentShader(a, b, dynamicStates)
+        && equalFragmentOutput(a, b, dynamicStates);
+}
+
+template<PipelineLibraryPart part>
+size_t PipelineLibraryPartHash<part>::operator()(const PipelineDescription& desc) const {
+    size_t seed = 0;
+
+    if constexpr (part == PipelineLibraryPart::VERTEX_INPUT) hashVertexInput(seed, desc, dynamicStates);
+    if constexpr (part == PipelineLibraryPart::PRE_RASTERIZATION) hashPreRasterization(seed, desc, dynamicStates);
+    if constexpr (part == PipelineLibraryPart::FRAGMENT_SHADER) hashFragmentShader(seed, desc, dynamicStates);
+    if constexpr (part == PipelineLibraryPart::FRAGMENT_OUTPUT) hashFragmentOutput(seed, desc, dynamicStates);
+
+    return seed;
+}
+
+template<PipelineLibraryPart part>
+bool PipelineLibraryPartEqual<part>::operator()(const PipelineDescription& a, const PipelineDescription& b) const {
+    if constexpr (part == PipelineLibraryPart::VERTEX_INPUT) return equalVertexInput(a, b, dynamicStates);
+    if constexpr (part == PipelineLibraryPart::PRE_RASTERIZATION) return equalPreRasterization(a, b, dynamicStates);
+    if constexpr (part == PipelineLibraryPart::FRAGMENT_SHADER) return equalFragmentShader(a, b, dynamicStates);
+    if constexpr (part == PipelineLibraryPart::FRAGMENT_OUTPUT) return equalFragmentOutput(a, b, dynamicStates);
+}
+
+template struct PipelineLibraryPartHash<PipelineLibraryPart::VERTEX_INPUT>;
+template struct PipelineLibraryPartHash<PipelineLibraryPart::PRE_RASTERIZATION>;
+template struct PipelineLibraryPartHash<PipelineLibraryPart::FRAGMENT_SHADER>;
+template struct PipelineLibraryPartHash<PipelineLibraryPart::FRAGMENT_OUTPUT>;
+template struct PipelineLibraryPartEqual<PipelineLibraryPart::VERTEX_INPUT>;
+template struct PipelineLibraryPartEqual<PipelineLibraryPart::PRE_RASTERIZATION>;
+template struct PipelineLibraryPartEqual<PipelineLibraryPart::FRAGMENT_SHADER>;
+template struct PipelineLibraryPartEqual<PipelineLibraryPart::FRAGMENT_OUTPUT>;
+
+size_t ComputePipelineDescriptionHash::operator()(const ComputePipelineDescription& desc) const {
+    size_t seed = 0;
+
+    hashStage(seed, desc.shader.getComputeStage());
+    desc.constants.Hash(seed);
+    for (const DescriptorBinding& binding : desc.bindings) {
+        hashCombine(seed, binding.binding);
+        hashCombine(seed, binding.type);
+    }
+    hashPushConstants(seed, desc.pushConstants);
+
+    return seed;
+}
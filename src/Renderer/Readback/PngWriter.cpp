@@ -0,0 +1,52 @@
+#include "pch.hpp"
+#include "Renderer/Readback/PngWriter.hpp"
+
+#include "Utils.hpp"
+#include "stb_image_write.h"
+
+#include <format>
+
+PngWriter::PngWriter(std::filesystem::path directory, std::string prefix, bool opaque)
+    : m_directory(std::move(directory)), m_prefix(std::move(prefix)), m_opaque(opaque) {
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+}
+
+void PngWriter::Write(const ReadbackImage& image) {
+    bool swapRedBlue = false;
+    switch (image.format) {
+        case vk::Format::eR8G8B8A8Unorm:
+        case vk::Format::eR8G8B8A8Srgb:
+            break;
+        case vk::Format::eB8G8R8A8Unorm:
+        case vk::Format::eB8G8R8A8Srgb:
+            swapRedBlue = true;
+            break;
+        default:
+            DEBUG_PRINT("PngWriter: unsupported format " + vk::to_string(image.format) + " for " + image.resource);
+            ++m_failed;
+            return;
+    }
+
+    const size_t pixelCount = static_cast<size_t>(image.extent.width) * image.extent.height;
+    ByteArray rgba(image.pixels.begin(), image.pixels.begin() + pixelCount * 4u);
+    if (swapRedBlue || m_opaque) {
+        for (size_t i = 0; i < pixelCount; ++i) {
+            std::byte* pixel = rgba.data() + i * 4u;
+            if (swapRedBlue) std::swap(pixel[0], pixel[2]);
+            if (m_opaque) pixel[3] = std::byte{ 0xFF };
+        }
+    }
+
+    const std::filesystem::path path = m_directory / std::format("{}{}_{}_{:06}.png", m_prefix, image.resource, image.output, image.frame);
+    const int result = stbi_write_png(path.string().c_str(),
+            static_cast<int>(image.extent.width), static_cast<int>(image.extent.height), 4,
+            rgba.data(), static_cast<int>(image.extent.width * 4u));
+
+    if (result == 0) {
+        DEBUG_PRINT("PngWriter: failed to write " + path.string());
+        ++m_failed;
+        return;
+    }
+    ++m_written;
+}
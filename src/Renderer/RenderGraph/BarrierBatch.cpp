@@ -0,0 +1,188 @@
+#include "pch.hpp"
+#include "Renderer/RenderGraph/BarrierBatch.hpp"
+
+namespace RenderGraph {
+    namespace {
+        struct LayoutSync {
+            vk::PipelineStageFlags2 stages {};
+            vk::AccessFlags2 access {};
+        };
+
+        constexpr vk::AccessFlags2 WRITE_ACCESS = vk::AccessFlagBits2::eColorAttachmentWrite
+                                                | vk::AccessFlagBits2::eDepthStencilAttachmentWrite
+                                                | vk::AccessFlagBits2::eTransferWrite
+                                                | vk::AccessFlagBits2::eShaderStorageWrite
+                                                | vk::AccessFlagBits2::eMemoryWrite;
+
+        bool overlaps(uint32_t baseA, uint32_t countA, uint32_t baseB, uint32_t countB) {
+            return baseA < baseB + countB && baseB < baseA + countA;
+        }
+
+        // Both ranges resolved, no VK_REMAINING_*
+        bool overlaps(const vk::ImageSubresourceRange& a, const vk::ImageSubresourceRange& b) {
+            return (a.aspectMask & b.aspectMask)
+                && overlaps(a.baseMipLevel, a.levelCount, b.baseMipLevel, b.levelCount)
+                && overlaps(a.baseArrayLayer, a.layerCount, b.baseArrayLayer, b.layerCount);
+        }
+
+        // Work that uses an image in `layout`: what a barrier has to wait for (source side)
+        // or hold back (destination side)
+        LayoutSync getLayoutSync(vk::ImageLayout layout) {
+            switch (layout) {
+                case vk::ImageLayout::eUndefined:
+                case vk::ImageLayout::ePresentSrcKHR:
+                    return { vk::PipelineStageFlagBits2::eNone, vk::AccessFlagBits2::eNone };
+                case vk::ImageLayout::eColorAttachmentOptimal:
+                    return { vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+                             vk::AccessFlagBits2::eColorAttachmentRead | vk::AccessFlagBits2::eColorAttachmentWrite };
+                case vk::ImageLayout::eDepthStencilAttachmentOptimal:
+                case vk::ImageLayout::eDepthAttachmentOptimal:
+                case vk::ImageLayout::eStencilAttachmentOptimal:
+                    return { vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests,
+                             vk::AccessFlagBits2::eDepthStencilAttachmentRead | vk::AccessFlagBits2::eDepthStencilAttachmentWrite };
+                case vk::ImageLayout::eShaderReadOnlyOptimal:
+                case vk::ImageLayout::eDepthStencilReadOnlyOptimal:
+                case vk::ImageLayout::eDepthReadOnlyOptimal:
+                case vk::ImageLayout::eStencilReadOnlyOptimal:
+                    return { vk::PipelineStageFlagBits2::eFragmentShader | vk::PipelineStageFlagBits2::eComputeShader,
+                             vk::AccessFlagBits2::eShaderSampledRead };
+                case vk::ImageLayout::eTransferSrcOptimal:
+                    return { vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferRead };
+                case vk::ImageLayout::eTransferDstOptimal:
+                    return { vk::PipelineStageFlagBits2::eTransfer, vk::AccessFlagBits2::eTransferWrite };
+                case vk::ImageLayout::eGeneral:
+                    // Storage images, plus clears and copies that target them in place
+                    return { vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eFragmentShader | vk::PipelineStageFlagBits2::eTransfer,
+                             vk::AccessFlagBits2::eShaderStorageRead | vk::AccessFlagBits2::eShaderStorageWrite
+                             | vk::AccessFlagBits2::eTransferRead | vk::AccessFlagBits2::eTransferWrite };
+                default:
+                    return { vk::PipelineStageFlagBits2::eAllCommands,
+                             vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite };
+            }
+        }
+    }
+
+    void BarrierBatch::Transition(ImageResource& image, const vk::ImageSubresourceRange& range, vk::ImageLayout newLayout) {
+        if (newLayout == vk::ImageLayout::eUndefined) return;
+
+        // First use, or the image was re-described (format, mips, layers) since it was last tracked
+        const vk::ImageAspectFlags aspects = getAspectMask(image.format);
+        if (!image.layouts.isTracking(aspects, image.mipLevels, image.arrayLayers)) {
+            image.layouts.Reset(aspects, image.mipLevels, image.arrayLayers, vk::ImageLayout::eUndefined);
+        }
+
+        // Only layouts are tracked, not whether the last use wrote: staying in a layout that can be
+        // written (attachments, transfer destination, eGeneral) still gets a barrier, so a pass that
+        // loads, blends or depth-tests into an attachment waits for the previous pass's writes
+        const LayoutSync dst = getLayoutSync(newLayout);
+        const bool orderUnchanged = static_cast<bool>(dst.access & WRITE_ACCESS);
+
+        for (const LayoutTransition& transition : image.layouts.Transition(resolveRange(image, range), newLayout, orderUnchanged)) {
+            const LayoutSync src = getLayoutSync(transition.oldLayout);
+
+            AddImageBarrier({
+                    .srcStageMask = src.stages,
+                    .srcAccessMask = src.access & WRITE_ACCESS,    // Only writes need to be made available
+                    .dstStageMask = dst.stages,
+                    .dstAccessMask = dst.access,
+                    .oldLayout = transition.oldLayout,
+                    .newLayout = newLayout,
+                    .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .image = image.image,
+                    .subresourceRange = transition.range
+                });
+        }
+    }
+
+    void BarrierBatch::AddImageBarrier(const vk::ImageMemoryBarrier2& barrier) {
+        auto overlapping = [&barrier] (const vk::ImageMemoryBarrier2& other) {
+            return other.image == barrier.image && overlaps(other.subresourceRange, barrier.subresourceRange);
+        };
+
+        // After the last group that touches the same subresources
+        size_t group = m_imageBarriers.size();
+        while (group > 0u && std::ranges::none_of(m_imageBarriers[group - 1u], overlapping)) {
+            --group;
+        }
+
+        if (group > 0u) {
+            // Same subresources: nothing runs in between, so one barrier goes straight to the last layout
+            std::vector<vk::ImageMemoryBarrier2>& previous = m_imageBarriers[group - 1u];
+            if (std::ranges::count_if(previous, overlapping) == 1) {
+                vk::ImageMemoryBarrier2& merged = *std::ranges::find_if(previous, overlapping);
+                if (merged.subresourceRange == barrier.subresourceRange) {
+                    merged.newLayout = barrier.newLayout;
+                    merged.dstStageMask |= barrier.dstStageMask;
+                    merged.dstAccessMask |= barrier.dstAccessMask;
+                    return;
+                }
+            }
+        }
+
+        if (group == m_imageBarriers.size()) m_imageBarriers.emplace_back();
+        m_imageBarriers[group].push_back(barrier);
+    }
+
+    void BarrierBatch::Access(BufferResource& buffer, const BufferSync& sync, bool isWrite) {
+        const bool written = static_cast<bool>(buffer.lastWrite.stages);
+
+        BufferSync src {};
+        if (isWrite) {
+            // Waits for the last write and every read since; reads only need the execution dependency
+            src = { buffer.lastWrite.stages | buffer.readsSinceWrite.stages, buffer.lastWrite.access };
+        }
+        else if (written) {
+            // Stages/accesses a previous barrier already made the write visible to are skipped
+            const bool covered = !(sync.stages & ~buffer.readsSinceWrite.stages)
+                && !(sync.access & ~buffer.readsSinceWrite.access);
+            if (!covered) src = buffer.lastWrite;
+        }
+
+        if (src.stages) {
+            m_bufferBarriers.push_back({
+                    .srcStageMask = src.stages,
+                    .srcAccessMask = src.access,
+                    .dstStageMask = sync.stages,
+                    .dstAccessMask = sync.access,
+                    .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                    .buffer = buffer.buffer,
+                    .offset = 0u,
+                    .size = vk::WholeSize
+                });
+        }
+
+        if (isWrite) {
+            buffer.lastWrite = sync;
+            buffer.readsSinceWrite = {};
+        }
+        else {
+            buffer.readsSinceWrite.stages |= sync.stages;
+            buffer.readsSinceWrite.access |= sync.access;
+        }
+    }
+
+    void BarrierBatch::Flush(const vk::raii::CommandBuffer& cmd) {
+        if (empty()) return;
+
+        if (m_imageBarriers.empty()) m_imageBarriers.emplace_back();
+
+        cmd.pipelineBarrier2(vk::DependencyInfo {
+                    .bufferMemoryBarrierCount = static_cast<uint32_t>(m_bufferBarriers.size()),
+                    .pBufferMemoryBarriers = m_bufferBarriers.data(),
+                    .imageMemoryBarrierCount = static_cast<uint32_t>(m_imageBarriers.front().size()),
+                    .pImageMemoryBarriers = m_imageBarriers.front().data()
+                });
+
+        for (size_t group = 1u; group < m_imageBarriers.size(); ++group) {
+            cmd.pipelineBarrier2(vk::DependencyInfo {
+                        .imageMemoryBarrierCount = static_cast<uint32_t>(m_imageBarriers[group].size()),
+                        .pImageMemoryBarriers = m_imageBarriers[group].data()
+                    });
+        }
+
+        m_imageBarriers.clear();
+        m_bufferBarriers.clear();
+    }
+}
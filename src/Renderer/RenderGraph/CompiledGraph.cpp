@@ -0,0 +1,331 @@
+#include "pch.hpp"
+#include "Renderer/RenderGraph/RenderGraph.hpp"
+#include "Renderer/RenderGraph/CompiledGraph.hpp"
+
+#include <cstring>
+#include <string_view>
+
+namespace RenderGraph {
+    namespace {
+        constexpr uint64_t alignRecord(uint64_t offset) {
+            return (offset + 7u) & ~uint64_t(7u);
+        }
+
+        // Views `count` records in place, nullopt if they do not fit or are misaligned
+        template<typename T>
+        std::optional<std::span<const T>> viewRecords(std::span<const std::byte> blob, uint64_t offset, uint32_t count) {
+            if (offset > blob.size() || count > (blob.size() - offset) / sizeof(T)) return std::nullopt;
+            if (reinterpret_cast<uintptr_t>(blob.data() + offset) % alignof(T) != 0u) return std::nullopt;
+
+            return std::span<const T>(reinterpret_cast<const T*>(blob.data() + offset), count);
+        }
+
+        template<typename T>
+        void writeRecords(ByteArray& blob, uint64_t offset, std::span<const T> records) {
+            if (records.empty()) return;
+            std::memcpy(blob.data() + offset, records.data(), records.size_bytes());
+        }
+
+        bool isSlice(uint32_t first, uint32_t count, size_t total) {
+            return first <= total && count <= total - first;
+        }
+    }
+
+    uint64_t RenderGraph::getDescriptionHash(const PipelineDescriptionHash& pipelineHash) const {
+        size_t seed = Compiled::VERSION;
+
+        std::vector<const ImageResource*> resources;
+        resources.reserve(m_resources.size());
+        for (const auto& [name, resource] : m_resources) {
+            resources.push_back(&resource);
+        }
+        std::ranges::sort(resources, {}, &ImageResource::name);
+
+        for (const ImageResource* resource : resources) {
+            hashCombine(seed, resource->name);
+            hashCombine(seed, static_cast<int32_t>(resource->format));
+            hashCombine(seed, static_cast<VkImageUsageFlags>(resource->usage));
+            hashCombine(seed, resource->external);
+            hashCombine(seed, resource->persistent);
+            hashCombine(seed, resource->mipLevels);
+            hashCombine(seed, resource->arrayLayers);
+            hashCombine(seed, static_cast<uint32_t>(resource->samples));
+            hashCombine(seed, resource->resolveTarget);
+
+            // External and relative images follow the swapchain, only their relation affects the plan
+            if (resource->relativeExtent) {
+                hashCombine(seed, resource->relativeExtent->relativeTo);
+                hashCombine(seed, resource->relativeExtent->scale);
+                hashCombine(seed, resource->relativeExtent->dynamic);
+            }
+            else if (!resource->external) {
+                hashCombine(seed, resource->extent.width);
+                hashCombine(seed, resource->extent.height);
+            }
+        }
+
+        std::vector<const BufferResource*> buffers;
+        buffers.reserve(m_bufferResources.size());
+        for (const auto& [name, buffer] : m_bufferResources) {
+            buffers.push_back(&buffer);
+        }
+        std::ranges::sort(buffers, {}, &BufferResource::name);
+
+        for (const BufferResource* buffer : buffers) {
+            hashCombine(seed, buffer->name);
+            hashCombine(seed, static_cast<VkBufferUsageFlags>(buffer->usage));
+            hashCombine(seed, buffer->external);
+        }
+
+        // Insertion order matters: Sort() is stable with respect to it
+        for (const std::unique_ptr<RenderPass>& node : m_nodes) {
+            hashCombine(seed, node->name);
+            hashCombine(seed, node->enabled);
+            for (const std::string& read : node->reads) hashCombine(seed, read);
+            hashCombine(seed, node->reads.size());
+            for (const std::string& write : node->writes) hashCombine(seed, write);
+            hashCombine(seed, node->writes.size());
+
+            // Unordered maps: combine commutatively so iteration order does not matter
+            auto hashRanges = [&seed] (const std::unordered_map<std::string, vk::ImageSubresourceRange>& ranges) {
+                size_t combined = 0u;
+                for (const auto& [name, range] : ranges) {
+                    size_t rangeSeed = 0u;
+                    hashCombine(rangeSeed, name);
+                    hashCombine(rangeSeed, static_cast<VkImageAspectFlags>(range.aspectMask));
+                    hashCombine(rangeSeed, range.baseMipLevel);
+                    hashCombine(rangeSeed, range.levelCount);
+                    hashCombine(rangeSeed, range.baseArrayLayer);
+                    hashCombine(rangeSeed, range.layerCount);
+                    combined += rangeSeed;
+                }
+                hashCombine(seed, combined);
+            };
+            hashRanges(node->readRanges);
+            hashRanges(node->writeRanges);
+
+            auto hashLayouts = [&seed] (const std::unordered_map<std::string, vk::ImageLayout>& layouts) {
+                size_t combined = 0u;
+                for (const auto& [name, layout] : layouts) {
+                    size_t layoutSeed = 0u;
+                    hashCombine(layoutSeed, name);
+                    hashCombine(layoutSeed, static_cast<int32_t>(layout));
+                    combined += layoutSeed;
+                }
+                hashCombine(seed, combined);
+            };
+            hashLayouts(node->readLayouts);
+            hashLayouts(node->writeLayouts);
+
+            auto hashBufferSyncs = [&seed] (const std::unordered_map<std::string, BufferSync>& syncs) {
+                size_t combined = 0u;
+                for (const auto& [name, sync] : syncs) {
+                    size_t syncSeed = 0u;
+                    hashCombine(syncSeed, name);
+                    hashCombine(syncSeed, static_cast<VkPipelineStageFlags2>(sync.stages));
+                    hashCombine(syncSeed, static_cast<VkAccessFlags2>(sync.access));
+                    combined += syncSeed;
+                }
+                hashCombine(seed, combined);
+            };
+            hashBufferSyncs(node->readBufferSyncs);
+            hashBufferSyncs(node->writeBufferSyncs);
+
+            for (const PipelineDescription& pipelineDesc : node->getPipelineDescriptions()) {
+                hashCombine(seed, pipelineHash(pipelineDesc));
+            }
+            for (const ComputePipelineDescription& pipelineDesc : node->getComputePipelineDescriptions()) {
+                hashCombine(seed, ComputePipelineDescriptionHash{}(pipelineDesc));
+            }
+        }
+
+        return static_cast<uint64_t>(seed);
+    }
+
+    ByteArray RenderGraph::SerializeCompiled(uint64_t descriptionHash, const PipelineDescriptionHash& pipelineHash) const {
+        if (isDirty()) return {};
+
+        std::string strings;
+        auto addString = [&strings] (const std::string& value) -> Compiled::String {
+            Compiled::String string { .offset = static_cast<uint32_t>(strings.size()), .length = static_cast<uint32_t>(value.size()) };
+            strings += value;
+            return string;
+        };
+
+        std::vector<Compiled::Resource> resources;
+        std::unordered_map<const ImageResource*, uint32_t> resourceIndices;
+        for (const auto& [name, resourcePlan] : m_resourcePlans) {
+            resourceIndices.insert({ &m_resources.at(name), static_cast<uint32_t>(resources.size()) });
+            resources.push_back({
+                    .name = addString(name),
+                    .firstPass = resourcePlan.firstPass,
+                    .lastPass = resourcePlan.lastPass,
+                    .aliasSlot = resourcePlan.aliasSlot,
+                });
+        }
+
+        std::vector<Compiled::Pass> passes;
+        std::vector<Compiled::Transition> transitions;
+        std::vector<uint64_t> pipelineKeys;
+        passes.reserve(m_sortedNodes.size());
+        for (const RenderPass* node : m_sortedNodes) {
+            Compiled::Pass pass {
+                .name = addString(node->name),
+                .firstTransition = static_cast<uint32_t>(transitions.size()),
+                .firstPipelineKey = static_cast<uint32_t>(pipelineKeys.size()),
+                .flags = node->active ? uint32_t(Compiled::Pass::ACTIVE) : 0u,
+            };
+
+            for (const PlannedTransition& transition : node->transitions) {
+                transitions.push_back({
+                        .resource = resourceIndices.at(transition.resource),
+                        .layout = static_cast<int32_t>(transition.layout),
+                        .aspectMask = static_cast<VkImageAspectFlags>(transition.range.aspectMask),
+                        .baseMipLevel = transition.range.baseMipLevel,
+                        .levelCount = transition.range.levelCount,
+                        .baseArrayLayer = transition.range.baseArrayLayer,
+                        .layerCount = transition.range.layerCount,
+                    });
+            }
+            for (const PipelineDescription& pipelineDesc : node->getPipelineDescriptions()) {
+                pipelineKeys.push_back(static_cast<uint64_t>(pipelineHash(pipelineDesc)));
+            }
+            for (const ComputePipelineDescription& pipelineDesc : node->getComputePipelineDescriptions()) {
+                pipelineKeys.push_back(static_cast<uint64_t>(ComputePipelineDescriptionHash{}(pipelineDesc)));
+            }
+
+            pass.transitionCount = static_cast<uint32_t>(transitions.size()) - pass.firstTransition;
+            pass.pipelineKeyCount = static_cast<uint32_t>(pipelineKeys.size()) - pass.firstPipelineKey;
+            passes.push_back(pass);
+        }
+
+        Compiled::Header header {
+            .descriptionHash = descriptionHash,
+            .passCount = static_cast<uint32_t>(passes.size()),
+            .resourceCount = static_cast<uint32_t>(resources.size()),
+            .transitionCount = static_cast<uint32_t>(transitions.size()),
+            .pipelineKeyCount = static_cast<uint32_t>(pipelineKeys.size()),
+            .stringBytes = static_cast<uint32_t>(strings.size()),
+        };
+        header.passOffset = alignRecord(sizeof(Compiled::Header));
+        header.resourceOffset = alignRecord(header.passOffset + passes.size() * sizeof(Compiled::Pass));
+        header.transitionOffset = alignRecord(header.resourceOffset + resources.size() * sizeof(Compiled::Resource));
+        header.pipelineKeyOffset = alignRecord(header.transitionOffset + transitions.size() * sizeof(Compiled::Transition));
+        header.stringOffset = alignRecord(header.pipelineKeyOffset + pipelineKeys.size() * sizeof(uint64_t));
+
+        ByteArray blob(header.stringOffset + strings.size());
+        writeRecords(blob, 0u, std::span<const Compiled::Header>(&header, 1u));
+        writeRecords(blob, header.passOffset, std::span<const Compiled::Pass>(passes));
+        writeRecords(blob, header.resourceOffset, std::span<const Compiled::Resource>(resources));
+        writeRecords(blob, header.transitionOffset, std::span<const Compiled::Transition>(transitions));
+        writeRecords(blob, header.pipelineKeyOffset, std::span<const uint64_t>(pipelineKeys));
+        writeRecords(blob, header.stringOffset, std::span<const char>(strings));
+
+        return blob;
+    }
+
+    LoadCompiledResult RenderGraph::LoadCompiled(std::span<const std::byte> blob, uint64_t descriptionHash) {
+        const auto headerRecord = viewRecords<Compiled::Header>(blob, 0u, 1u);
+        if (!headerRecord || headerRecord->empty()) return LoadCompiledResult::INVALID_BLOB;
+
+        const Compiled::Header& header = headerRecord->front();
+        if (header.magic != Compiled::MAGIC || header.version != Compiled::VERSION) {
+            return LoadCompiledResult::INVALID_BLOB;
+        }
+        if (header.descriptionHash != descriptionHash) {
+            return LoadCompiledResult::DESCRIPTION_CHANGED;
+        }
+
+        const auto passes = viewRecords<Compiled::Pass>(blob, header.passOffset, header.passCount);
+        const auto resources = viewRecords<Compiled::Resource>(blob, header.resourceOffset, header.resourceCount);
+        const auto transitions = viewRecords<Compiled::Transition>(blob, header.transitionOffset, header.transitionCount);
+        const auto pipelineKeys = viewRecords<uint64_t>(blob, header.pipelineKeyOffset, header.pipelineKeyCount);
+        const auto strings = viewRecords<char>(blob, header.stringOffset, header.stringBytes);
+        if (!passes || !resources || !transitions || !pipelineKeys || !strings) {
+            return LoadCompiledResult::INVALID_BLOB;
+        }
+
+        auto getString = [&strings] (const Compiled::String& string) -> std::optional<std::string> {
+            if (!isSlice(string.offset, string.length, strings->size())) return std::nullopt;
+            return std::string(std::string_view(strings->data() + string.offset, string.length));
+        };
+
+        // Everything is staged first so a rejected blob leaves the execution order untouched
+        ResolveChangedPasses();
+
+        std::vector<ImageResource*> resolvedResources;
+        std::unordered_map<std::string, ResourcePlan> resourcePlans;
+        for (const Compiled::Resource& resource : *resources) {
+            const std::optional<std::string> name = getString(resource.name);
+            if (!name) return LoadCompiledResult::INVALID_BLOB;
+
+            auto resourceItr = m_resources.find(*name);
+            if (resourceItr == m_resources.end()) return LoadCompiledResult::UNKNOWN_NAME;
+
+            resolvedResources.push_back(&resourceItr->second);
+            resourcePlans.insert({ *name, ResourcePlan {
+                        .firstPass = resource.firstPass,
+                        .lastPass = resource.lastPass,
+                        .aliasSlot = resource.aliasSlot,
+                    } });
+        }
+
+        ExecutionOrder sorted;
+        std::vector<std::vector<PlannedTransition>> plannedTransitions;
+        for (const Compiled::Pass& pass : *passes) {
+            const std::optional<std::string> name = getString(pass.name);
+            if (!name) return LoadCompiledResult::INVALID_BLOB;
+            if (!isSlice(pass.firstTransition, pass.transitionCount, transitions->size())
+                    || !isSlice(pass.firstPipelineKey, pass.pipelineKeyCount, pipelineKeys->size())) {
+                return LoadCompiledResult::INVALID_BLOB;
+            }
+
+            auto nodeItr = findNode(*name);
+            if (nodeItr == m_nodes.end() || !(*nodeItr)->resolved) return LoadCompiledResult::UNKNOWN_NAME;
+
+            std::vector<PlannedTransition>& passTransitions = plannedTransitions.emplace_back();
+            for (const Compiled::Transition& transition : transitions->subspan(pass.firstTransition, pass.transitionCount)) {
+                if (transition.resource >= resolvedResources.size()) return LoadCompiledResult::INVALID_BLOB;
+
+                passTransitions.push_back({
+                        .resource = resolvedResources[transition.resource],
+                        .range = {
+                            static_cast<vk::ImageAspectFlags>(transition.aspectMask),
+                            transition.baseMipLevel,
+                            transition.levelCount,
+                            transition.baseArrayLayer,
+                            transition.layerCount
+                        },
+                        .layout = static_cast<vk::ImageLayout>(transition.layout),
+                    });
+            }
+            sorted.push_back(nodeItr->get());
+        }
+
+        for (std::unique_ptr<RenderPass>& node : m_nodes) {
+            node->scheduled = false;
+            node->active = false;
+            node->transitions.clear();
+        }
+
+        m_executionOrder.clear();
+        for (size_t i = 0u; i < sorted.size(); ++i) {
+            RenderPass* node = sorted[i];
+            node->scheduled = true;
+            node->active = (*passes)[i].flags & Compiled::Pass::ACTIVE;
+            node->transitions = std::move(plannedTransitions[i]);
+
+            if (node->active) m_executionOrder.push_back(node);
+        }
+
+        m_sortedNodes = std::move(sorted);
+        m_resourcePlans = std::move(resourcePlans);
+        BuildBufferPlan();
+
+        m_structureChanged = false;
+        m_activityChanged = false;
+        m_changedResources.clear();
+
+        return LoadCompiledResult::OK;
+    }
+}
@@ -0,0 +1,114 @@
+#include "pch.hpp"
+#include "Renderer/RenderGraph/SubresourceLayouts.hpp"
+
+void SubresourceLayouts::Reset(vk::ImageAspectFlags aspects, uint32_t mipLevels, uint32_t arrayLayers, vk::ImageLayout layout) {
+    m_aspects = aspects;
+    m_mipLevels = mipLevels;
+    m_arrayLayers = arrayLayers;
+
+    const size_t aspectCount = std::ranges::count_if(ASPECTS,
+            [aspects] (vk::ImageAspectFlagBits aspect) {
+                return static_cast<bool>(aspects & aspect);
+            });
+
+    m_layouts.assign(aspectCount * arrayLayers * mipLevels, layout);
+}
+
+uint32_t SubresourceLayouts::getAspectIndex(vk::ImageAspectFlagBits aspect) const {
+    uint32_t index = 0u;
+    for (vk::ImageAspectFlagBits tracked : ASPECTS) {
+        if (tracked == aspect) break;
+        if (m_aspects & tracked) ++index;
+    }
+    return index;
+}
+
+vk::ImageLayout SubresourceLayouts::getLayout(vk::ImageAspectFlagBits aspect, uint32_t mipLevel, uint32_t arrayLayer) const {
+    if (!(m_aspects & aspect) || mipLevel >= m_mipLevels || arrayLayer >= m_arrayLayers) {
+        return vk::ImageLayout::eUndefined;
+    }
+
+    return m_layouts[getIndex(getAspectIndex(aspect), mipLevel, arrayLayer)];
+}
+
+std::vector<LayoutTransition> SubresourceLayouts::Transition(const vk::ImageSubresourceRange& range, vk::ImageLayout newLayout, bool includeUnchanged) {
+    std::vector<LayoutTransition> transitions;
+
+    const uint32_t lastMip = std::min(range.baseMipLevel + range.levelCount, m_mipLevels);
+    const uint32_t lastLayer = std::min(range.baseArrayLayer + range.layerCount, m_arrayLayers);
+
+    for (vk::ImageAspectFlagBits aspect : ASPECTS) {
+        if (!(m_aspects & aspect) || !(range.aspectMask & aspect)) continue;
+        const uint32_t aspectIndex = getAspectIndex(aspect);
+
+        // Transitions emitted for the previous layer, extended when this layer needs the same ones
+        size_t previousBegin = transitions.size();
+        size_t previousEnd = transitions.size();
+
+        for (uint32_t layer = range.baseArrayLayer; layer < lastLayer; ++layer) {
+            std::vector<LayoutTransition> runs;
+
+            for (uint32_t mip = range.baseMipLevel; mip < lastMip; ++mip) {
+                vk::ImageLayout& layout = m_layouts[getIndex(aspectIndex, mip, layer)];
+                if (layout == newLayout && !includeUnchanged) continue;
+
+                const bool extendsRun = !runs.empty()
+                    && runs.back().oldLayout == layout
+                    && runs.back().range.baseMipLevel + runs.back().range.levelCount == mip;
+
+                if (extendsRun) ++runs.back().range.levelCount;
+                else runs.push_back({ .range = { aspect, mip, 1u, layer, 1u }, .oldLayout = layout });
+
+                layout = newLayout;
+            }
+
+            const bool sameAsPrevious = !runs.empty() && previousEnd - previousBegin == runs.size()
+                && std::ranges::equal(runs, std::span(transitions).subspan(previousBegin, runs.size()),
+                        [layer] (const LayoutTransition& run, const LayoutTransition& previous) {
+                            return run.oldLayout == previous.oldLayout
+                                && run.range.baseMipLevel == previous.range.baseMipLevel
+                                && run.range.levelCount == previous.range.levelCount
+                                && previous.range.baseArrayLayer + previous.range.layerCount == layer;
+                        });
+
+            if (sameAsPrevious) {
+                for (size_t i = previousBegin; i < previousEnd; ++i) {
+                    ++transitions[i].range.layerCount;
+                }
+                continue;
+            }
+
+            previousBegin = transitions.size();
+            transitions.insert(transitions.end(), runs.begin(), runs.end());
+            previousEnd = transitions.size();
+        }
+    }
+
+    // Depth and stencil moving together share one barrier
+    for (auto stencilItr = transitions.begin(); stencilItr != transitions.end();) {
+        if (stencilItr->range.aspectMask != vk::ImageAspectFlagBits::eStencil) {
+            ++stencilItr;
+            continue;
+        }
+
+        auto depthItr = std::ranges::find_if(transitions,
+                [&stencil = *stencilItr] (const LayoutTransition& depth) {
+                    return depth.range.aspectMask == vk::ImageAspectFlagBits::eDepth
+                        && depth.oldLayout == stencil.oldLayout
+                        && depth.range.baseMipLevel == stencil.range.baseMipLevel
+                        && depth.range.levelCount == stencil.range.levelCount
+                        && depth.range.baseArrayLayer == stencil.range.baseArrayLayer
+                        && depth.range.layerCount == stencil.range.layerCount;
+                });
+
+        if (depthItr == transitions.end()) {
+            ++stencilItr;
+            continue;
+        }
+
+        depthItr->range.aspectMask |= vk::ImageAspectFlagBits::eStencil;
+        stencilItr = transitions.erase(stencilItr);
+    }
+
+    return transitions;
+}
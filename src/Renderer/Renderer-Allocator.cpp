@@ -3,6 +3,8 @@
 #include "Renderer/Renderer-Exceptions.hpp"
 #include <vma/vk_mem_alloc.h>
 
+#include "Utils.hpp"
+
 void Renderer::CreateAllocator() {
     VmaAllocatorCreateInfo createInfo{};
     createInfo.device = *m_device;
@@ -10,6 +12,11 @@ void Renderer::CreateAllocator() {
     createInfo.instance = *m_instance;
     createInfo.vulkanApiVersion = VK_API_VERSION_1_3;
 
+    // Without it VMA estimates usage from its own blocks and budgets 80% of each heap
+    if (m_memoryBudgetSupported) {
+        createInfo.flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+    }
+
     VmaAllocator allocator{};
     VkResult result = vmaCreateAllocator(&createInfo, &allocator);
     if (result != VK_SUCCESS) {
@@ -17,4 +24,99 @@ void Renderer::CreateAllocator() {
     }
 
     m_allocator = allocator;
+    m_heapsNearBudget.clear();
+}
+
+MemoryCategory Renderer::getMemoryCategory(vk::BufferUsageFlags usage) {
+    if (usage & vk::BufferUsageFlagBits::eVertexBuffer) return MemoryCategory::VERTEX_BUFFERS;
+    if (usage & vk::BufferUsageFlagBits::eUniformBuffer) return MemoryCategory::UNIFORM_BUFFERS;
+    if (usage & vk::BufferUsageFlagBits::eStorageBuffer) return MemoryCategory::STORAGE_BUFFERS;
+
+    return MemoryCategory::TRANSFER_BUFFERS;
+}
+
+std::vector<MemoryHeapBudget> Renderer::getHeapBudgets() const {
+    const VkPhysicalDeviceMemoryProperties* memoryProperties = nullptr;
+    vmaGetMemoryProperties(m_allocator, &memoryProperties);
+
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets {};
+    vmaGetHeapBudgets(m_allocator, budgets.data());
+
+    VkDeviceSize deviceLocalLimit = 0u;
+    {
+        std::scoped_lock lock(m_memoryBudgetMutex);
+        deviceLocalLimit = m_memoryBudgetSettings.deviceLocalLimit;
+    }
+
+    std::vector<MemoryHeapBudget> heaps;
+    heaps.reserve(memoryProperties->memoryHeapCount);
+    for (uint32_t i = 0; i < memoryProperties->memoryHeapCount; ++i) {
+        const VmaBudget& budget = budgets[i];
+        const bool deviceLocal = memoryProperties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+
+        heaps.push_back({
+                .heapIndex = i,
+                .deviceLocal = deviceLocal,
+                .usage = budget.usage,
+                .budget = deviceLocal && deviceLocalLimit != 0u ? std::min(budget.budget, deviceLocalLimit) : budget.budget,
+                .blockBytes = budget.statistics.blockBytes,
+                .allocationBytes = budget.statistics.allocationBytes,
+                .blockCount = budget.statistics.blockCount,
+                .allocationCount = budget.statistics.allocationCount
+            });
+    }
+
+    return heaps;
+}
+
+MemoryStats Renderer::getMemoryStats() const {
+    MemoryStats stats {
+        .driverBudget = m_memoryBudgetSupported,
+        .heaps = getHeapBudgets()
+    };
+
+    for (size_t i = 0; i < stats.categories.size(); ++i) {
+        stats.categories[i] = m_memoryTracker.get(static_cast<MemoryCategory>(i));
+    }
+
+    return stats;
+}
+
+void Renderer::SetMemoryBudget(const MemoryBudgetSettings& settings) {
+    std::scoped_lock lock(m_memoryBudgetMutex);
+    m_memoryBudgetSettings = settings;
+}
+
+// Once per frame: VMA refreshes the driver budget on frame index changes
+void Renderer::CheckMemoryBudget() {
+    vmaSetCurrentFrameIndex(m_allocator, static_cast<uint32_t>(frameCount));
+
+    const std::vector<MemoryHeapBudget> heaps = getHeapBudgets();
+    m_heapsNearBudget.resize(heaps.size(), false);
+
+    float warningRatio = 0.0f;
+    std::function<void(const MemoryHeapBudget&)> onNearBudget;
+    {
+        std::scoped_lock lock(m_memoryBudgetMutex);
+        warningRatio = m_memoryBudgetSettings.warningRatio;
+        onNearBudget = m_memoryBudgetSettings.onNearBudget;
+    }
+
+    for (const MemoryHeapBudget& heap : heaps) {
+        const bool nearBudget = heap.budget != 0u
+            && static_cast<double>(heap.usage) >= static_cast<double>(heap.budget) * warningRatio;
+
+        // Reported when crossing, not every frame spent over it
+        const bool wasNearBudget = m_heapsNearBudget[heap.heapIndex];
+        m_heapsNearBudget[heap.heapIndex] = nearBudget;
+        if (!nearBudget || wasNearBudget) continue;
+
+        if (onNearBudget) {
+            onNearBudget(heap);
+        }
+        else {
+            DEBUG_PRINT("Memory heap " + std::to_string(heap.heapIndex) + " near budget: "
+                    + std::to_string(heap.usage >> 20u) + " / " + std::to_string(heap.budget >> 20u) + " MiB");
+        }
+    }
 }
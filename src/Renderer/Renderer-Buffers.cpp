@@ -0,0 +1,167 @@
+#include "pch.hpp"
+#include "Renderer/Renderer.hpp"
+#include "Renderer/Renderer-Exceptions.hpp"
+#include <vma/vk_mem_alloc.h>
+
+#include <cstring>
+
+void Renderer::AllocateBuffer(Buffer& buffer) {
+    VmaAllocationCreateInfo allocInfo{};
+    allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+
+    vk::BufferUsageFlags usage = buffer.usage;
+    switch (buffer.memory) {
+        case BufferMemory::GPU_ONLY:
+            allocInfo.usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+            usage |= vk::BufferUsageFlagBits::eTransferDst;
+            break;
+
+        // Transfer destination for the staged writes of snapshot uniforms
+        case BufferMemory::UPLOAD_SEQUENTIAL_WRITE:
+            allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+            usage |= vk::BufferUsageFlagBits::eTransferDst;
+            break;
+
+        case BufferMemory::READBACK:
+            allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+            usage |= vk::BufferUsageFlagBits::eTransferDst;
+            break;
+
+        // Device local and host visible when there is such memory (ReBAR, integrated GPUs, lavapipe),
+        // otherwise VMA falls back to device local only and writes are staged
+        case BufferMemory::DEVICE_LOCAL_HOST_VISIBLE:
+            allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT
+                | VMA_ALLOCATION_CREATE_HOST_ACCESS_ALLOW_TRANSFER_INSTEAD_BIT
+                | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+            usage |= vk::BufferUsageFlagBits::eTransferDst;
+            break;
+    }
+
+    vk::BufferCreateInfo bufferInfo {
+        .size = buffer.size,
+        .usage = usage,
+        .sharingMode = vk::SharingMode::eExclusive
+    };
+
+    VmaAllocationInfo allocationInfo {};
+    if (vmaCreateBuffer(m_allocator, &static_cast<const VkBufferCreateInfo&>(bufferInfo), &allocInfo, &buffer.buffer, &buffer.allocation, &allocationInfo) != VK_SUCCESS) {
+        throw CreateBufferError("Failed to allocate buffer " + buffer.name);
+    }
+    m_memoryTracker.Track(m_allocator, buffer.allocation, getMemoryCategory(buffer.usage));
+
+    VkMemoryPropertyFlags memoryFlags = 0u;
+    vmaGetAllocationMemoryProperties(m_allocator, buffer.allocation, &memoryFlags);
+
+    buffer.usage = usage;
+    buffer.mapped = allocationInfo.pMappedData;
+    buffer.hostCoherent = memoryFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+}
+
+void Renderer::WriteBuffer(const Buffer& buffer, std::span<const std::byte> data, VkDeviceSize offset) {
+    if (data.empty()) return;
+    assert(offset + data.size() <= buffer.size && "Write past the end of the buffer");
+
+    if (buffer.mapped) {
+        std::memcpy(static_cast<std::byte*>(buffer.mapped) + offset, data.data(), data.size());
+
+        // No-op on coherent memory
+        if (!buffer.hostCoherent) vmaFlushAllocation(m_allocator, buffer.allocation, offset, data.size());
+        return;
+    }
+
+    StageBufferWrite(buffer, data, offset);
+}
+
+// Copied by the next RecordUploads(), ordered after every frame submitted before it: safe for
+// buffers frames in flight still read, mapped or not
+void Renderer::StageBufferWrite(const Buffer& buffer, std::span<const std::byte> data, VkDeviceSize offset) {
+    if (data.empty()) return;
+    assert(offset + data.size() <= buffer.size && "Write past the end of the buffer");
+
+    vk::BufferCreateInfo stagingInfo {
+        .size = data.size(),
+        .usage = vk::BufferUsageFlagBits::eTransferSrc,
+        .sharingMode = vk::SharingMode::eExclusive
+    };
+
+    VmaAllocationCreateInfo allocInfo{};
+    allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    PendingUpload upload {
+        .destination = buffer.buffer,
+        .offset = offset,
+        .size = data.size()
+    };
+
+    VmaAllocationInfo allocationInfo {};
+    if (vmaCreateBuffer(m_allocator, &static_cast<const VkBufferCreateInfo&>(stagingInfo), &allocInfo, &upload.staging, &upload.stagingAllocation, &allocationInfo) != VK_SUCCESS) {
+        throw CreateBufferError("Failed to allocate a staging buffer for " + buffer.name);
+    }
+    m_memoryTracker.Track(m_allocator, upload.stagingAllocation, MemoryCategory::TRANSFER_BUFFERS);
+
+    std::memcpy(allocationInfo.pMappedData, data.data(), data.size());
+    vmaFlushAllocation(m_allocator, upload.stagingAllocation, 0u, VK_WHOLE_SIZE);
+
+    std::scoped_lock lock(m_uploadMutex);
+    m_pendingUploads.push_back(upload);
+}
+
+void Renderer::ReadBuffer(const Buffer& buffer, std::span<std::byte> data, VkDeviceSize offset) const {
+    if (data.empty()) return;
+    assert(buffer.mapped && "Only mapped buffers can be read, allocate it as READBACK");
+    assert(offset + data.size() <= buffer.size && "Read past the end of the buffer");
+
+    if (!buffer.hostCoherent) vmaInvalidateAllocation(m_allocator, buffer.allocation, offset, data.size());
+
+    std::memcpy(data.data(), static_cast<const std::byte*>(buffer.mapped) + offset, data.size());
+}
+
+// Submitted ahead of the frame's outputs: the barriers order the copies after the previous
+// frames' reads and before anything this frame does
+vk::CommandBuffer Renderer::RecordUploads() {
+    std::vector<PendingUpload> uploads;
+    {
+        std::scoped_lock lock(m_uploadMutex);
+        uploads.swap(m_pendingUploads);
+    }
+    if (uploads.empty()) return nullptr;
+
+    const vk::raii::CommandBuffer& buffer = m_frameCommandPools[frameIndex]->AllocatePrimary();
+    buffer.begin({ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+
+    // Previous frames may have written the destinations too (WAW), not only read them
+    vk::MemoryBarrier2 beforeCopies {
+        .srcStageMask = vk::PipelineStageFlagBits2::eAllCommands,
+        .srcAccessMask = vk::AccessFlagBits2::eMemoryWrite,
+        .dstStageMask = vk::PipelineStageFlagBits2::eCopy,
+        .dstAccessMask = vk::AccessFlagBits2::eTransferWrite
+    };
+    buffer.pipelineBarrier2({ .memoryBarrierCount = 1u, .pMemoryBarriers = &beforeCopies });
+
+    for (const PendingUpload& upload : uploads) {
+        buffer.copyBuffer(upload.staging, upload.destination,
+                vk::BufferCopy {
+                    .srcOffset = 0u,
+                    .dstOffset = upload.offset,
+                    .size = upload.size
+                });
+
+        m_deletionQueue.Push(frameCount,
+                [allocator = m_allocator, &tracker = m_memoryTracker, upload] () {
+                    tracker.Untrack(allocator, upload.stagingAllocation);
+                    vmaDestroyBuffer(allocator, upload.staging, upload.stagingAllocation);
+                });
+    }
+
+    vk::MemoryBarrier2 afterCopies {
+        .srcStageMask = vk::PipelineStageFlagBits2::eCopy,
+        .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+        .dstStageMask = vk::PipelineStageFlagBits2::eAllCommands,
+        .dstAccessMask = vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite
+    };
+    buffer.pipelineBarrier2({ .memoryBarrierCount = 1u, .pMemoryBarriers = &afterCopies });
+
+    buffer.end();
+    return *buffer;
+}
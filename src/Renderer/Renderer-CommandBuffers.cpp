@@ -2,36 +2,35 @@
 #include "Renderer/Renderer.hpp"
 #include "Renderer/RenderGraph/RenderGraph.hpp"
 
-void Renderer::CreateCommandPool() {
+void Renderer::CreateCommandPools() {
+    // Static secondaries are re-recorded one at a time
     vk::CommandPoolCreateInfo poolInfo {
         .flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
         .queueFamilyIndex = m_graphicsFamilyIndex
     };
     m_commandPool = vk::raii::CommandPool(m_device, poolInfo);
-}
 
-void Renderer::CreateCommandBuffers() {
-    vk::CommandBufferAllocateInfo bufferInfo {
-        .commandPool = m_commandPool,
-        .level = vk::CommandBufferLevel::ePrimary,
-        .commandBufferCount = MAX_FRAMES_IN_FLIGHT // 1 buffer per frame
-    };
-    
-    m_commandBuffers.clear();
-    m_commandBuffers = vk::raii::CommandBuffers(m_device, bufferInfo);
+    assert(m_frameCommandPools.empty());
+    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+        m_frameCommandPools.push_back(std::make_unique<FrameCommandPools>(m_device, m_graphicsFamilyIndex));
+    }
 }
 
 void Renderer::CreateSyncObjects() {
-    assert(m_presentCompleteSemaphores.empty() && m_renderFinishedSemaphores.empty() && m_framesInFlightFence.empty());
-	
-    for (size_t i = 0; i < m_swapChainImages.size(); i++)
+    assert(m_framesInFlightFence.empty());
+
+    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
 	{
-		m_renderFinishedSemaphores.emplace_back(m_device, vk::SemaphoreCreateInfo());
+	    m_framesInFlightFence.emplace_back(m_device, vk::FenceCreateInfo{.flags = vk::FenceCreateFlagBits::eSignaled});
 	}
+}
+
+void Renderer::CreateOutputSyncObjects(RenderOutput& output) {
+    // Render finished semaphores are per swapchain image and live with the swapchain
+    assert(output.presentCompleteSemaphores.empty());
 
     for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
 	{
-	    m_presentCompleteSemaphores.emplace_back(m_device, vk::SemaphoreCreateInfo());
-	    m_framesInFlightFence.emplace_back(m_device, vk::FenceCreateInfo{.flags = vk::FenceCreateFlagBits::eSignaled});
+	    output.presentCompleteSemaphores.emplace_back(m_device, vk::SemaphoreCreateInfo());
 	}
 }
@@ -0,0 +1,84 @@
+#include "pch.hpp"
+#include "Renderer/Renderer.hpp"
+#include "Renderer/Pipeline/Pipeline.hpp"
+#include <vma/vk_mem_alloc.h>
+
+void Renderer::CollectRetiredResources() {
+    // Fences signal in submission order: once this frame's fence is waited on,
+    // every frame up to (frameCount - MAX_FRAMES_IN_FLIGHT) has completed
+    if (frameCount < MAX_FRAMES_IN_FLIGHT) return;
+
+    m_deletionQueue.Flush(frameCount - MAX_FRAMES_IN_FLIGHT);
+}
+
+// Resources are tagged with the frame currently being recorded: the last one that can reference them
+
+void Renderer::DestroyBuffer(const std::shared_ptr<Buffer>& buffer) {
+    if (!buffer) return;
+
+    std::erase(m_buffers, buffer);
+
+    m_deletionQueue.Push(frameCount,
+            [allocator = m_allocator, &tracker = m_memoryTracker, buffer] () {
+                tracker.Untrack(allocator, buffer->allocation);
+                vmaDestroyBuffer(allocator, buffer->buffer, buffer->allocation);
+                buffer->buffer = VK_NULL_HANDLE;
+                buffer->allocation = {};
+            });
+}
+
+void Renderer::DestroyBuffers(std::span<const std::shared_ptr<Buffer>> buffers) {
+    std::vector<std::shared_ptr<Buffer>> retired;
+    retired.reserve(buffers.size());
+
+    for (const std::shared_ptr<Buffer>& buffer : buffers) {
+        if (!buffer) continue;
+
+        std::erase(m_buffers, buffer);
+        retired.push_back(buffer);
+    }
+
+    if (retired.empty()) return;
+
+    m_deletionQueue.Push(frameCount,
+            [allocator = m_allocator, &tracker = m_memoryTracker, retired = std::move(retired)] () {
+                for (const std::shared_ptr<Buffer>& buffer : retired) {
+                    tracker.Untrack(allocator, buffer->allocation);
+                    vmaDestroyBuffer(allocator, buffer->buffer, buffer->allocation);
+                    buffer->buffer = VK_NULL_HANDLE;
+                    buffer->allocation = {};
+                }
+            });
+}
+
+void Renderer::DestroyPipeline(const std::shared_ptr<Pipeline>& pipeline) {
+    if (!pipeline) return;
+
+    std::erase(m_pipelines, pipeline);
+
+    // The registry entry goes once no other description shares the vk::Pipeline
+    const bool handleShared = std::ranges::any_of(m_pipelines,
+            [&pipeline] (const std::shared_ptr<Pipeline>& other) {
+                return other->handle == pipeline->handle;
+            });
+    if (!handleShared) {
+        auto isHandle = [&pipeline] (const auto& entry) {
+            return entry.second == pipeline->handle;
+        };
+        std::erase_if(m_pipelineRegistry, isHandle);
+        std::erase_if(m_computePipelineRegistry, isHandle);
+    }
+
+    // Passes may still hold a reference, the last owner releases the vk objects
+    m_deletionQueue.Retire(frameCount, std::shared_ptr<Pipeline>(pipeline));
+}
+
+void Renderer::DestroyImage(VkImage image, VmaAllocation allocation) {
+    if (image == VK_NULL_HANDLE) return;
+
+    m_deletionQueue.Push(frameCount,
+            [allocator = m_allocator, &tracker = m_memoryTracker, image, allocation] () {
+                tracker.Untrack(allocator, allocation);
+                vmaDestroyImage(allocator, image, allocation);
+            });
+}
@@ -0,0 +1,246 @@
+#include "pch.hpp"
+#include "Renderer/Renderer.hpp"
+#include "Utils.hpp"
+#include "Renderer/Renderer-Exceptions.hpp"
+#include "Renderer/RenderGraph/RenderGraph.hpp"
+#include "Renderer/RenderGraph/ImageResource.hpp"
+#include "Renderer/RenderGraph/Passes/UpscalePass.hpp"
+#include <vma/vk_mem_alloc.h>
+
+// Graph-owned images: everything but external resources (BackBuffer) is allocated here
+
+void Renderer::AllocateGraphImages(RenderGraph::RenderGraph& renderGraph) {
+    // Only images some scheduled pass uses, the others are allocated once a pass needs them
+    const auto& resourcePlans = renderGraph.getResourcePlans();
+
+    for (auto& [name, resource] : renderGraph.getResources()) {
+        if (resource.external || !resourcePlans.contains(name)) continue;
+
+        // Resized, e.g. swapchain-relative after a resize: only these are reallocated
+        if (resource.image && resource.allocatedExtent != resource.extent) {
+            ReleaseGraphImage(resource);
+        }
+
+        if (!resource.image) {
+            AllocateGraphImage(resource);
+        }
+    }
+}
+
+void Renderer::AllocateGraphImage(ImageResource& resource) {
+    constexpr vk::ImageUsageFlags attachmentUsage = vk::ImageUsageFlagBits::eColorAttachment
+        | vk::ImageUsageFlagBits::eDepthStencilAttachment
+        | vk::ImageUsageFlagBits::eInputAttachment;
+
+    // A multisampled target that is only rendered to and resolved never has to leave tile memory
+    const bool isTransient = resource.samples != vk::SampleCountFlagBits::e1
+        && !resource.persistent
+        && !(resource.usage & ~attachmentUsage);
+
+    vk::ImageCreateInfo imageInfo {
+        .imageType = vk::ImageType::e2D,
+        .format = resource.format,
+        .extent = { resource.extent.width, resource.extent.height, 1u },
+        .mipLevels = resource.mipLevels,
+        .arrayLayers = resource.arrayLayers,
+        .samples = resource.samples,
+        .tiling = vk::ImageTiling::eOptimal,
+        .usage = resource.usage | (isTransient ? vk::ImageUsageFlagBits::eTransientAttachment : vk::ImageUsageFlags{}),
+        .sharingMode = vk::SharingMode::eExclusive,
+        .initialLayout = vk::ImageLayout::eUndefined
+    };
+
+    VmaAllocationCreateInfo allocInfo{};
+    allocInfo.usage = isTransient ? VMA_MEMORY_USAGE_GPU_LAZILY_ALLOCATED : VMA_MEMORY_USAGE_AUTO;
+
+    VkImage image = VK_NULL_HANDLE;
+    VmaAllocation allocation = nullptr;
+    VkResult result = vmaCreateImage(m_allocator, &static_cast<const VkImageCreateInfo&>(imageInfo), &allocInfo, &image, &allocation, nullptr);
+    if (result != VK_SUCCESS && isTransient) {
+        // No lazily allocated memory type, usual on desktop GPUs
+        allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+        result = vmaCreateImage(m_allocator, &static_cast<const VkImageCreateInfo&>(imageInfo), &allocInfo, &image, &allocation, nullptr);
+    }
+    if (result != VK_SUCCESS) {
+        throw CreateImageError("Failed to allocate render graph image " + resource.name);
+    }
+    m_memoryTracker.Track(m_allocator, allocation, MemoryCategory::GRAPH_IMAGES);
+
+    // Sampled views of depth/stencil images only see depth, attachments need every aspect
+    vk::ImageAspectFlags viewAspects = getAspectMask(resource.format);
+    if ((viewAspects & vk::ImageAspectFlagBits::eDepth) && !(resource.usage & vk::ImageUsageFlagBits::eDepthStencilAttachment)) {
+        viewAspects = vk::ImageAspectFlagBits::eDepth;
+    }
+
+    vk::ImageViewCreateInfo viewInfo {
+        .image = image,
+        .viewType = resource.arrayLayers > 1u ? vk::ImageViewType::e2DArray : vk::ImageViewType::e2D,
+        .format = resource.format,
+        .subresourceRange = { viewAspects, 0u, resource.mipLevels, 0u, resource.arrayLayers }
+    };
+
+    resource.image = image;
+    resource.allocation = allocation;
+    resource.ownedView = vk::raii::ImageView(m_device, viewInfo);
+    resource.view = *resource.ownedView;
+    resource.allocatedExtent = resource.extent;
+    resource.layouts.Reset(getAspectMask(resource.format), resource.mipLevels, resource.arrayLayers, vk::ImageLayout::eUndefined);
+}
+
+void Renderer::ReleaseGraphImage(ImageResource& resource) {
+    const VkImage image = resource.image;
+    const VmaAllocation allocation = resource.allocation;
+
+    resource.image = nullptr;
+    resource.allocation = nullptr;
+    resource.view = nullptr;
+
+    // The view goes first, both in the same frame bucket
+    Retire(std::move(resource.ownedView));
+    if (allocation) {
+        DestroyImage(image, allocation);
+    }
+}
+
+void Renderer::DestroyGraphImages(RenderGraph::RenderGraph& renderGraph) {
+    for (auto& [name, resource] : renderGraph.getResources()) {
+        if (!resource.allocation) continue;
+
+        resource.ownedView = nullptr;
+        m_memoryTracker.Untrack(m_allocator, resource.allocation);
+        vmaDestroyImage(m_allocator, resource.image, resource.allocation);
+
+        resource.image = nullptr;
+        resource.allocation = nullptr;
+        resource.view = nullptr;
+    }
+}
+
+// Graph buffers: every non-external one is allocated, whether a pass uses it yet or not
+
+void Renderer::AllocateGraphBuffers(RenderGraph::RenderGraph& renderGraph) {
+    for (auto& [name, resource] : renderGraph.getBufferResources()) {
+        if (resource.external) continue;
+
+        if (resource.buffer && resource.allocatedSize != resource.size) {
+            ReleaseGraphBuffer(resource);
+        }
+        if (resource.buffer) continue;
+
+        vk::BufferCreateInfo bufferInfo {
+            .size = resource.size,
+            .usage = resource.usage,
+            .sharingMode = vk::SharingMode::eExclusive
+        };
+
+        VmaAllocationCreateInfo allocInfo{};
+        allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation allocation = nullptr;
+        if (vmaCreateBuffer(m_allocator, &static_cast<const VkBufferCreateInfo&>(bufferInfo), &allocInfo, &buffer, &allocation, nullptr) != VK_SUCCESS) {
+            throw CreateBufferError("Failed to allocate render graph buffer " + resource.name);
+        }
+        m_memoryTracker.Track(m_allocator, allocation, MemoryCategory::GRAPH_BUFFERS);
+
+        resource.buffer = buffer;
+        resource.allocation = allocation;
+        resource.allocatedSize = resource.size;
+        resource.lastWrite = {};
+        resource.readsSinceWrite = {};
+    }
+}
+
+void Renderer::ReleaseGraphBuffer(BufferResource& resource) {
+    const VkBuffer buffer = resource.buffer;
+    const VmaAllocation allocation = resource.allocation;
+
+    resource.buffer = nullptr;
+    resource.allocation = nullptr;
+    resource.allocatedSize = 0u;
+
+    if (!allocation) return;
+
+    m_deletionQueue.Push(frameCount,
+            [allocator = m_allocator, &tracker = m_memoryTracker, buffer, allocation] () {
+                tracker.Untrack(allocator, allocation);
+                vmaDestroyBuffer(allocator, buffer, allocation);
+            });
+}
+
+void Renderer::DestroyGraphBuffers(RenderGraph::RenderGraph& renderGraph) {
+    for (auto& [name, resource] : renderGraph.getBufferResources()) {
+        if (!resource.allocation) continue;
+
+        m_memoryTracker.Untrack(m_allocator, resource.allocation);
+        vmaDestroyBuffer(m_allocator, resource.buffer, resource.allocation);
+
+        resource.buffer = nullptr;
+        resource.allocation = nullptr;
+        resource.allocatedSize = 0u;
+    }
+}
+
+bool Renderer::EnableDynamicResolution(const DynamicResolution::Settings& settings, OutputId outputId) {
+    RenderOutput& output = *m_outputs.at(outputId);
+
+    const std::vector<vk::QueueFamilyProperties> queueFamilies = m_physicalDevice.getQueueFamilyProperties();
+    if (queueFamilies[m_graphicsFamilyIndex].timestampValidBits == 0u) {
+        return false;
+    }
+
+    // UpscalePass blits into BackBuffer, which only has eTransferDst where the surface allows it
+    const vk::FormatFeatureFlags backBufferFeatures = m_physicalDevice.getFormatProperties(output.surfaceFormat.format).optimalTilingFeatures;
+    if (!(output.swapChainUsage & vk::ImageUsageFlagBits::eTransferDst) || !(backBufferFeatures & vk::FormatFeatureFlagBits::eBlitDst)) {
+        DEBUG_PRINT("Dynamic resolution: the swapchain cannot be the destination of a blit");
+        return false;
+    }
+
+    RenderGraph::RenderGraph& renderGraph = getRenderGraph(outputId);
+    for (const std::unique_ptr<RenderGraph::RenderPass>& node : renderGraph.getNodes()) {
+        const auto* upscale = dynamic_cast<const RenderGraph::UpscalePass*>(node.get());
+        if (!upscale) continue;
+
+        auto source = renderGraph.getResource(upscale->getSource());
+        if (!source) continue;
+
+        const vk::FormatFeatureFlags sourceFeatures = m_physicalDevice.getFormatProperties(source.value().get().format).optimalTilingFeatures;
+        if (!(sourceFeatures & vk::FormatFeatureFlagBits::eBlitSrc) || !(sourceFeatures & vk::FormatFeatureFlagBits::eSampledImageFilterLinear)) {
+            DEBUG_PRINT("Dynamic resolution: " + upscale->getSource() + " cannot be blitted with a linear filter");
+            return false;
+        }
+    }
+
+    output.timestampPool = vk::raii::QueryPool(m_device, vk::QueryPoolCreateInfo {
+                .queryType = vk::QueryType::eTimestamp,
+                .queryCount = 2u * MAX_FRAMES_IN_FLIGHT
+            });
+    output.timestampsWritten.assign(MAX_FRAMES_IN_FLIGHT, false);
+    output.dynamicResolution.emplace(settings);
+
+    // Allocate once at the maximum scale, the controller only moves the render area from here on
+    if (!renderGraph.SetResolutionScale(settings.maxScale, settings.maxScale).empty()) {
+        AllocateGraphImages(renderGraph);
+    }
+
+    return true;
+}
+
+// Called once the frame slot's fence has signaled, so its timestamps are available
+void Renderer::UpdateDynamicResolution(RenderOutput& output) {
+    if (!output.timestampsWritten[frameIndex] || !output.renderGraph) return;
+    output.timestampsWritten[frameIndex] = false;
+
+    auto [result, timestamps] = output.timestampPool.getResults<uint64_t>(frameIndex * 2u, 2u,
+            2u * sizeof(uint64_t), sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+    if (result != vk::Result::eSuccess) return;
+
+    const double timestampPeriod = m_physicalDevice.getProperties().limits.timestampPeriod;
+    const double gpuFrameTimeMs = static_cast<double>(timestamps[1] - timestamps[0]) * timestampPeriod * 1e-6;
+
+    const float scale = output.dynamicResolution->Update(gpuFrameTimeMs);
+    if (scale == output.renderGraph->getResolutionScale()) return;
+
+    // Same max scale: only render extents change, nothing is reallocated
+    output.renderGraph->SetResolutionScale(scale, output.dynamicResolution->getSettings().maxScale);
+}
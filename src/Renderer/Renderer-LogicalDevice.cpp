@@ -23,7 +23,7 @@ void Renderer::CreateLogicalDeviceAndQueues() {
 
     std::optional<QueueFamilyIndex> presentIndex;
 
-    bool graphicsQueueSupportsPresent = QueueSupportsPresent(graphicsIndex, m_physicalDevice, m_surface);
+    bool graphicsQueueSupportsPresent = QueueSupportsPresent(graphicsIndex, m_physicalDevice, getPrimaryOutput().surface);
 
     if (graphicsQueueSupportsPresent) {
         presentIndex = graphicsIndex;
@@ -32,7 +32,7 @@ void Renderer::CreateLogicalDeviceAndQueues() {
         // IF graphics queue does not support present
         // find queue that supports both graphics and present
         for (size_t i{0}; i < queueFamilyProperties.size() && !graphicsQueueSupportsPresent; ++i) {
-            if ((queueFamilyProperties[i].queueFlags & vk::QueueFlagBits::eGraphics) && QueueSupportsPresent(i, m_physicalDevice, m_surface)) {
+            if ((queueFamilyProperties[i].queueFlags & vk::QueueFlagBits::eGraphics) && QueueSupportsPresent(i, m_physicalDevice, getPrimaryOutput().surface)) {
                 graphicsIndex = i;
                 presentIndex = graphicsIndex;
                 graphicsQueueSupportsPresent = true;
@@ -43,7 +43,7 @@ void Renderer::CreateLogicalDeviceAndQueues() {
         // IF NO queue supporting both present and graphics
         // Find first OTHER queue supporting present
         for (size_t i{0}; i < queueFamilyProperties.size() && !graphicsQueueSupportsPresent; ++i) {
-            if (QueueSupportsPresent(i, m_physicalDevice, m_surface)) {
+            if (QueueSupportsPresent(i, m_physicalDevice, getPrimaryOutput().surface)) {
                 presentIndex = i;
                 break;
             }
@@ -77,15 +77,64 @@ void Renderer::CreateLogicalDeviceAndQueues() {
         );
     }
 
+    std::vector<vk::ExtensionProperties> availableExtensions = m_physicalDevice.enumerateDeviceExtensionProperties();
+    auto isExtensionAvailable = [&availableExtensions] (const char* name) -> bool {
+        return std::ranges::any_of(availableExtensions, 
+                [name] (const vk::ExtensionProperties& properties) {
+                    return std::strcmp(name, properties.extensionName) == 0;
+                });
+    };
+
+    // Optional: extended dynamic state 3, only the states PipelineDescription can express
+    vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT supportedDynamicState3 {};
+    const bool dynamicState3Available = isExtensionAvailable(vk::EXTExtendedDynamicState3ExtensionName);
+    if (dynamicState3Available) {
+        supportedDynamicState3 = m_physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT>()
+                                    .get<vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT>();
+    }
+
+    // Optional: shader objects, an alternative to pipelines
+    bool shaderObjectAvailable = isExtensionAvailable(vk::EXTShaderObjectExtensionName);
+    if (shaderObjectAvailable) {
+        shaderObjectAvailable = m_physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceShaderObjectFeaturesEXT>()
+                                    .get<vk::PhysicalDeviceShaderObjectFeaturesEXT>().shaderObject;
+    }
+
+    // Optional: graphics pipeline libraries, pipelines linked from separately compiled parts
+    bool pipelineLibraryAvailable = isExtensionAvailable(vk::EXTGraphicsPipelineLibraryExtensionName)
+                                    && isExtensionAvailable(vk::KHRPipelineLibraryExtensionName);
+    if (pipelineLibraryAvailable) {
+        pipelineLibraryAvailable = m_physicalDevice.getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>()
+                                    .get<vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>().graphicsPipelineLibrary;
+    }
+
+    // Optional: push descriptors, only compute pipelines with bindings need them
+    const bool pushDescriptorAvailable = isExtensionAvailable(vk::KHRPushDescriptorExtensionName);
+
+    // Optional: heap usage and budget from the driver, other processes included
+    const bool memoryBudgetAvailable = isExtensionAvailable(vk::EXTMemoryBudgetExtensionName);
+
     vk::StructureChain<
         vk::PhysicalDeviceFeatures2,
         vk::PhysicalDeviceVulkan11Features,
         vk::PhysicalDeviceVulkan13Features,
-        vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT> featureChain = {
+        vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT,
+        vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT,
+        vk::PhysicalDeviceShaderObjectFeaturesEXT,
+        vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT> featureChain = {
         {},
         { .shaderDrawParameters = true },
         { .synchronization2 = true, .dynamicRendering = true },
-        { .extendedDynamicState = true }
+        { .extendedDynamicState = true },
+        {
+            .extendedDynamicState3DepthClampEnable = supportedDynamicState3.extendedDynamicState3DepthClampEnable,
+            .extendedDynamicState3PolygonMode = supportedDynamicState3.extendedDynamicState3PolygonMode,
+            .extendedDynamicState3RasterizationSamples = supportedDynamicState3.extendedDynamicState3RasterizationSamples,
+            .extendedDynamicState3ColorBlendEnable = supportedDynamicState3.extendedDynamicState3ColorBlendEnable,
+            .extendedDynamicState3ColorBlendEquation = supportedDynamicState3.extendedDynamicState3ColorBlendEquation
+        },
+        { .shaderObject = true },
+        { .graphicsPipelineLibrary = true }
     };
 
     std::vector<const char*> requiredExtensionsNames;
@@ -94,6 +143,49 @@ void Renderer::CreateLogicalDeviceAndQueues() {
         requiredExtensionsNames.push_back(extensions.name);
     }
 
+    if (dynamicState3Available) {
+        requiredExtensionsNames.push_back(vk::EXTExtendedDynamicState3ExtensionName);
+    }
+    else {
+        featureChain.unlink<vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT>();
+    }
+
+    if (shaderObjectAvailable) {
+        requiredExtensionsNames.push_back(vk::EXTShaderObjectExtensionName);
+    }
+    else {
+        featureChain.unlink<vk::PhysicalDeviceShaderObjectFeaturesEXT>();
+    }
+    m_shaderObjectsSupported = shaderObjectAvailable;
+
+    if (pipelineLibraryAvailable) {
+        requiredExtensionsNames.push_back(vk::KHRPipelineLibraryExtensionName);
+        requiredExtensionsNames.push_back(vk::EXTGraphicsPipelineLibraryExtensionName);
+    }
+    else {
+        featureChain.unlink<vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>();
+    }
+    m_pipelineLibrariesSupported = pipelineLibraryAvailable;
+
+    if (pushDescriptorAvailable) {
+        requiredExtensionsNames.push_back(vk::KHRPushDescriptorExtensionName);
+    }
+    m_pushDescriptorSupported = pushDescriptorAvailable;
+
+    if (memoryBudgetAvailable) {
+        requiredExtensionsNames.push_back(vk::EXTMemoryBudgetExtensionName);
+    }
+    m_memoryBudgetSupported = memoryBudgetAvailable;
+
+    // Extended dynamic state 1 and 2 are core in Vulkan 1.3
+    m_supportedDynamicStates = DynamicStateSupport {
+        .enabled = true,
+        .polygonMode = bool(supportedDynamicState3.extendedDynamicState3PolygonMode),
+        .depthClampEnable = bool(supportedDynamicState3.extendedDynamicState3DepthClampEnable),
+        .rasterizationSamples = bool(supportedDynamicState3.extendedDynamicState3RasterizationSamples),
+        .colorBlend = supportedDynamicState3.extendedDynamicState3ColorBlendEnable && supportedDynamicState3.extendedDynamicState3ColorBlendEquation
+    };
+
     vk::DeviceCreateInfo deviceCreateInfo {
         .pNext = &featureChain.get<vk::PhysicalDeviceFeatures2>(),
         .queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size()),
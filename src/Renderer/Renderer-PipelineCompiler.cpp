@@ -0,0 +1,188 @@
+#include "pch.hpp"
+#include "Renderer/Renderer.hpp"
+
+#include "Utils.hpp"
+#include "Renderer/Pipeline/Pipeline.hpp"
+#include "Renderer/Pipeline/PipelineDescription.hpp"
+#include "Renderer/RenderGraph/RenderPass.hpp"
+
+std::shared_ptr<Pipeline> Renderer::RequestPipeline(const PipelineDescription& desc, std::shared_ptr<const Pipeline> fallback) {
+    std::shared_ptr<Pipeline> pipeline = std::make_shared<Pipeline>(desc.name);
+    pipeline->fallback = std::move(fallback);
+
+    if (m_dynamicStates.enabled) {
+        pipeline->dynamicState = getDynamicPipelineState(desc);
+        pipeline->stateCache = &m_dynamicStateCache;
+    }
+
+    m_pipelines.push_back(pipeline);
+
+    auto handleItr = m_pipelineRegistry.find(desc);
+    if (handleItr != m_pipelineRegistry.end()) {
+        pipeline->handle = handleItr->second;
+        return pipeline;
+    }
+
+    // A structurally identical description is already being compiled
+    const PipelineDescriptionEqual equal { m_dynamicStates };
+    auto jobItr = std::ranges::find_if(m_pendingCompiles,
+            [&equal, &desc] (const std::shared_ptr<PipelineCompileJob>& job) {
+                return equal(job->desc, desc);
+            });
+    if (jobItr != m_pendingCompiles.end()) {
+        (*jobItr)->waiting.push_back(pipeline);
+        return pipeline;
+    }
+
+    std::shared_ptr<PipelineCompileJob> job = std::make_shared<PipelineCompileJob>();
+    job->desc = desc;
+    job->waiting.push_back(pipeline);
+    m_pendingCompiles.push_back(job);
+    m_pendingCompileCount = static_cast<uint32_t>(m_pendingCompiles.size());
+
+    ++m_queuedCompiles;
+    m_jobs.SubmitBackground(
+            [this, job] () {
+                CompilePipeline(job);
+            }, &m_backgroundJobs);
+
+    return pipeline;
+}
+
+Renderer::PipelineCompileStats Renderer::getPipelineCompileStats() const {
+    return PipelineCompileStats {
+        .queued = m_queuedCompiles,
+        .compiling = m_runningCompiles,
+        .pending = m_pendingCompileCount,
+        .completed = m_pipelinesCompiled,
+        .failed = m_pipelinesFailed
+    };
+}
+
+// On a job thread
+void Renderer::CompilePipeline(const std::shared_ptr<PipelineCompileJob>& job) {
+    --m_queuedCompiles;
+    if (m_stopCompiles) return;
+
+    ++m_runningCompiles;
+    try {
+        job->handle = CreatePipelineHandle(job->desc);
+    }
+    catch (const std::exception& e) {
+        job->error = e.what();
+    }
+    catch (...) {
+        job->error = "Unknown error";
+    }
+    --m_runningCompiles;
+
+    std::scoped_lock lock(m_compileMutex);
+    m_compiledJobs.push_back(job);
+}
+
+// Jobs not started yet return right away, the device must still be alive
+void Renderer::WaitForBackgroundJobs() {
+    m_stopCompiles = true;
+    m_jobs.Wait(m_backgroundJobs);
+
+    m_compiledJobs.clear();
+    m_pendingCompiles.clear();
+    m_pendingCompileCount = 0u;
+
+    std::scoped_lock lock(m_optimizedLinkMutex);
+    m_optimizedLinks.clear();
+}
+
+// Between frames, so nothing is recording with the Pipelines being updated
+void Renderer::PublishCompiledPipelines() {
+    std::vector<std::shared_ptr<PipelineCompileJob>> compiled;
+    {
+        std::scoped_lock lock(m_compileMutex);
+        compiled.swap(m_compiledJobs);
+    }
+
+    for (const std::shared_ptr<PipelineCompileJob>& job : compiled) {
+        std::erase(m_pendingCompiles, job);
+        m_pendingCompileCount = static_cast<uint32_t>(m_pendingCompiles.size());
+
+        if (!job->error.empty()) {
+            DEBUG_PRINT("Pipeline " + job->desc.name + " failed to compile, keeping its fallback: " + job->error);
+            ++m_pipelinesFailed;
+            continue;
+        }
+        ++m_pipelinesCompiled;
+
+        // Destroyed while compiling. No frame ever used the handle, it goes with the job.
+        std::erase_if(job->waiting,
+                [this] (const std::shared_ptr<Pipeline>& pipeline) {
+                    return std::ranges::find(m_pipelines, pipeline) == m_pipelines.end();
+                });
+        if (job->waiting.empty()) continue;
+
+        m_pipelineRegistry.insert({ job->desc, job->handle });
+        for (const std::shared_ptr<Pipeline>& pipeline : job->waiting) {
+            pipeline->handle = job->handle;
+        }
+    }
+}
+
+// Pipelines of passes about to be prepared do not depend on each other: their handles are created
+// by jobs and registered here, PrepareRenderPass() then finds them in the registries
+void Renderer::PrecompilePipelines(std::span<const std::unique_ptr<RenderGraph::RenderPass>> passes) {
+    const PipelineDescriptionEqual equal { m_dynamicStates };
+    const ComputePipelineDescriptionEqual computeEqual;
+
+    std::vector<PipelineDescription> graphics;
+    std::vector<ComputePipelineDescription> compute;
+    for (const std::unique_ptr<RenderGraph::RenderPass>& pass : passes) {
+        if (pass->renderer != nullptr) continue;
+
+        for (const PipelineDescription& desc : pass->getPipelineDescriptions()) {
+            if (desc.async || m_pipelineRegistry.contains(desc)) continue;
+            if (std::ranges::any_of(graphics, [&] (const PipelineDescription& other) { return equal(other, desc); })) continue;
+
+            graphics.push_back(desc);
+        }
+        for (const ComputePipelineDescription& desc : pass->getComputePipelineDescriptions()) {
+            if (m_computePipelineRegistry.contains(desc)) continue;
+            if (std::ranges::any_of(compute, [&] (const ComputePipelineDescription& other) { return computeEqual(other, desc); })) continue;
+
+            compute.push_back(desc);
+        }
+    }
+    if (graphics.size() + compute.size() < 2u) return;
+
+    std::vector<std::shared_ptr<PipelineHandle>> graphicsHandles(graphics.size());
+    std::vector<std::shared_ptr<PipelineHandle>> computeHandles(compute.size());
+
+    // Failed ones are left out: getOrCreatePipeline() tries again and throws the error
+    JobCounter counter;
+    for (size_t i = 0u; i < graphics.size(); ++i) {
+        m_jobs.Submit(
+                [this, &desc = graphics[i], &handle = graphicsHandles[i]] () {
+                    try {
+                        handle = CreatePipelineHandle(desc);
+                    }
+                    catch (...) {}
+                }, &counter);
+    }
+    for (size_t i = 0u; i < compute.size(); ++i) {
+        m_jobs.Submit(
+                [this, &desc = compute[i], &handle = computeHandles[i]] () {
+                    try {
+                        std::shared_ptr<PipelineHandle> created = std::make_shared<PipelineHandle>();
+                        CreateComputePipeline(desc, *created);
+                        handle = std::move(created);
+                    }
+                    catch (...) {}
+                }, &counter);
+    }
+    m_jobs.Wait(counter);
+
+    for (size_t i = 0u; i < graphics.size(); ++i) {
+        if (graphicsHandles[i]) m_pipelineRegistry.insert({ std::move(graphics[i]), std::move(graphicsHandles[i]) });
+    }
+    for (size_t i = 0u; i < compute.size(); ++i) {
+        if (computeHandles[i]) m_computePipelineRegistry.insert({ std::move(compute[i]), std::move(computeHandles[i]) });
+    }
+}
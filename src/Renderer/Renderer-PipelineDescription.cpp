@@ -6,6 +6,7 @@
 #include "Renderer/Vertex/VertexInfo.hpp"
 #include "Renderer/Renderer-Exceptions.hpp"
 #include "Renderer/Rasterizer/Rasterizer.hpp"
+#include "Renderer/Pipeline/Pipeline.hpp"
 #include "Renderer/Pipeline/PipelineDescription.hpp"
 
 static vk::raii::ShaderModule CreateShaderModule(const ByteArray& code, const vk::raii::Device& device) {
@@ -51,9 +52,11 @@ static vk::Format toVKFormat(const VertexAttributeType& type) {
     return {};
 }
 
-static vk::PipelineVertexInputStateCreateInfo getVKVertexInputInfo(const VertexInfo& vertexInfo) {
-    std::vector<vk::VertexInputBindingDescription> bindings;
-    std::vector<vk::VertexInputAttributeDescription> attributes;
+// The create info points into `bindings` and `attributes`
+static vk::PipelineVertexInputStateCreateInfo getVKVertexInputInfo(const VertexInfo& vertexInfo,
+        std::vector<vk::VertexInputBindingDescription>& bindings, std::vector<vk::VertexInputAttributeDescription>& attributes) {
+    bindings.clear();
+    attributes.clear();
 
     bindings.reserve(vertexInfo.bindings.size());
     attributes.reserve(vertexInfo.attributes.size());
@@ -120,6 +123,109 @@ static vk::FrontFace toVKFrontFace(FrontFace frontFace) {
     return {};
 }
 
+static vk::PrimitiveTopology toVKTopology(PrimitiveTopology topology) {
+    switch (topology) {
+        case PrimitiveTopology::TRIANGLE_LIST: return vk::PrimitiveTopology::eTriangleList;
+        case PrimitiveTopology::TRIANGLE_STRIP: return vk::PrimitiveTopology::eTriangleStrip;
+        case PrimitiveTopology::LINE_LIST: return vk::PrimitiveTopology::eLineList;
+        case PrimitiveTopology::LINE_STRIP: return vk::PrimitiveTopology::eLineStrip;
+        case PrimitiveTopology::POINT_LIST: return vk::PrimitiveTopology::ePointList;
+    }
+
+    return {};
+}
+
+static vk::CompareOp toVKCompareOp(DepthCompare compare) {
+    switch (compare) {
+        case DepthCompare::LESS: return vk::CompareOp::eLess;
+        case DepthCompare::LESS_OR_EQUAL: return vk::CompareOp::eLessOrEqual;
+        case DepthCompare::GREATER: return vk::CompareOp::eGreater;
+        case DepthCompare::GREATER_OR_EQUAL: return vk::CompareOp::eGreaterOrEqual;
+        case DepthCompare::EQUAL: return vk::CompareOp::eEqual;
+        case DepthCompare::ALWAYS: return vk::CompareOp::eAlways;
+    }
+
+    return {};
+}
+
+static vk::SampleCountFlagBits toVKSampleCount(SampleCount sampleCount) {
+    switch (sampleCount) {
+        case SampleCount::ONE: return vk::SampleCountFlagBits::e1;
+        case SampleCount::TWO: return vk::SampleCountFlagBits::e2;
+        case SampleCount::FOUR: return vk::SampleCountFlagBits::e4;
+        case SampleCount::EIGHT: return vk::SampleCountFlagBits::e8;
+        case SampleCount::SIXTEEN: return vk::SampleCountFlagBits::e16;
+        case SampleCount::THIRY_TWO: return vk::SampleCountFlagBits::e32;
+        case SampleCount::SIXTY_FOUR: return vk::SampleCountFlagBits::e64;
+    }
+
+    return vk::SampleCountFlagBits::e1;
+}
+
+static vk::ColorBlendEquationEXT getVKBlendEquation(BlendMode mode) {
+    switch (mode) {
+        case BlendMode::NONE:
+            return vk::ColorBlendEquationEXT {
+                .srcColorBlendFactor = vk::BlendFactor::eOne,
+                .dstColorBlendFactor = vk::BlendFactor::eZero,
+                .colorBlendOp        = vk::BlendOp::eAdd,
+                .srcAlphaBlendFactor = vk::BlendFactor::eOne,
+                .dstAlphaBlendFactor = vk::BlendFactor::eZero,
+                .alphaBlendOp        = vk::BlendOp::eAdd
+            };
+        case BlendMode::ONE_MINUS_SRC_ALPHA:
+            return vk::ColorBlendEquationEXT {
+                .srcColorBlendFactor = vk::BlendFactor::eSrcAlpha,
+                .dstColorBlendFactor = vk::BlendFactor::eOneMinusSrcAlpha,
+                .colorBlendOp        = vk::BlendOp::eAdd,
+                .srcAlphaBlendFactor = vk::BlendFactor::eOne,
+                .dstAlphaBlendFactor = vk::BlendFactor::eOneMinusSrcAlpha,
+                .alphaBlendOp        = vk::BlendOp::eAdd
+            };
+    }
+
+    return {};
+}
+
+static DynamicPipelineState getDynamicPipelineState(const PipelineDescription& desc) {
+    DynamicPipelineState state {
+        .cullMode = toVKCullMode(desc.rasterizer.faceCulling.cullFace),
+        .frontFace = toVKFrontFace(desc.rasterizer.faceCulling.frontFace),
+        .topology = toVKTopology(desc.topology),
+        .rasterizerDiscardEnable = desc.rasterizer.discardEnable,
+        .depthTestEnable = desc.depthTestEnabled,
+        .depthWriteEnable = desc.depthWriteEnabled,
+        .depthCompareOp = toVKCompareOp(desc.depthCompare),
+        .polygonMode = toVKPolygonMode(desc.rasterizer.polygonMode),
+        .depthClampEnable = desc.rasterizer.depthClampEnable,
+        .rasterizationSamples = toVKSampleCount(desc.sampleCount),
+        .colorBlendEnable = desc.colorBlend != BlendMode::NONE,
+        .colorBlendEquation = getVKBlendEquation(desc.colorBlend),
+        .colorAttachmentCount = static_cast<uint32_t>(desc.colorAttachments.size())
+    };
+
+    for (const VertexBindingDescription& binding : desc.vertexInfo.bindings) {
+        state.vertexBindings.emplace_back(
+                vk::VertexInputBindingDescription2EXT {
+                    .binding = binding.binding,
+                    .stride = binding.stride,
+                    .inputRate = toVKVertexInputRate(binding.inputRate),
+                    .divisor = 1
+                });
+    }
+    for (const VertexAttributeDescription& attribute : desc.vertexInfo.attributes) {
+        state.vertexAttributes.emplace_back(
+                vk::VertexInputAttributeDescription2EXT {
+                    .location = attribute.location,
+                    .binding = attribute.binding,
+                    .format = toVKFormat(attribute.type),
+                    .offset = attribute.offset
+                });
+    }
+
+    return state;
+}
+
 static vk::PipelineRasterizationStateCreateInfo getVKRasterizer(Rasterizer rasterizer) {
     vk::PipelineRasterizationStateCreateInfo createInfo {
         .depthClampEnable = toVKBool(rasterizer.depthClampEnable),
@@ -135,7 +241,41 @@ static vk::PipelineRasterizationStateCreateInfo getVKRasterizer(Rasterizer raste
     return createInfo;
 }
 
-std::vector<vk::PipelineShaderStageCreateInfo> Renderer::getShaderStages(GraphicsShader& shader) const {
+// Read once per module, same locking as getOrCreateShaderModule()
+std::shared_ptr<const ByteArray> Renderer::getShaderCode(ShaderModule& shaderModule) const {
+    {
+        std::scoped_lock lock(m_shaderModuleMutex);
+        if (shaderModule.code) return shaderModule.code;
+    }
+
+    std::expected<ByteArray, ReadFileError> rawDataExpected = readRawFile(shaderModule.path);
+    if (!rawDataExpected) {
+        throw PipelineCreation_Error("Error in reading " + shaderModule.path.string() + ": " + to_string(rawDataExpected.error()));
+    }
+
+    std::scoped_lock lock(m_shaderModuleMutex);
+    if (!shaderModule.code) shaderModule.code = std::make_shared<const ByteArray>(std::move(*rawDataExpected));
+    return shaderModule.code;
+}
+
+// Modules are created on first use, possibly by several jobs at once. Only the check and the store
+// hold m_shaderModuleMutex: reading and creating run in parallel, a module created twice is dropped
+// in favour of the one stored first.
+vk::ShaderModule Renderer::getOrCreateShaderModule(ShaderModule& shaderModule) const {
+    {
+        std::scoped_lock lock(m_shaderModuleMutex);
+        if (shaderModule.module != VK_NULL_HANDLE) return *shaderModule.module;
+    }
+
+    vk::raii::ShaderModule created = CreateShaderModule(*getShaderCode(shaderModule), m_device);
+
+    std::scoped_lock lock(m_shaderModuleMutex);
+    if (shaderModule.module == VK_NULL_HANDLE) shaderModule.module = std::move(created);
+    return *shaderModule.module;
+}
+
+std::vector<vk::PipelineShaderStageCreateInfo> Renderer::getShaderStages(PipelineDescription& desc) const {
+    GraphicsShader& shader = desc.shader;
     std::vector<vk::PipelineShaderStageCreateInfo> shaderStages;
 
     {
@@ -143,21 +283,12 @@ std::vector<vk::PipelineShaderStageCreateInfo> Renderer::getShaderStages(Graphic
         
         assert(vertex.module && "Vertex Stage should have a module");
 
-        if (vertex.module->module == VK_NULL_HANDLE) {
-            std::expected<ByteArray, ReadFileError> rawDataExpected = readRawFile(vertex.module->path);
-
-            if (!rawDataExpected) {
-                throw PipelineCreation_Error("Error in reading " + vertex.module->path.string() + ": " + to_string(rawDataExpected.error()));
-            }
-
-            vertex.module->module = CreateShaderModule(*rawDataExpected, m_device);
-        }
-
         shaderStages.emplace_back(
                 vk::PipelineShaderStageCreateInfo {
                     .stage = vk::ShaderStageFlagBits::eVertex,
-                    .module = vertex.module->module,
-                    .pName = vertex.entry.c_str()
+                    .module = getOrCreateShaderModule(*vertex.module),
+                    .pName = vertex.entry.c_str(),
+                    .pSpecializationInfo = desc.vertexConstants.getInfo()
                 }
             );
     }
@@ -166,21 +297,12 @@ std::vector<vk::PipelineShaderStageCreateInfo> Renderer::getShaderStages(Graphic
         
         assert(fragment.module && "Fragment Stage should have a module");
 
-        if (fragment.module->module == VK_NULL_HANDLE) {
-            std::expected<ByteArray, ReadFileError> rawDataExpected = readRawFile(fragment.module->path);
-
-            if (!rawDataExpected) {
-                throw PipelineCreation_Error("Error in reading " + fragment.module->path.string() + ": " + to_string(rawDataExpected.error()));
-            }
-
-            fragment.module->module = CreateShaderModule(*rawDataExpected, m_device);
-        }
-        
         shaderStages.emplace_back(
                 vk::PipelineShaderStageCreateInfo {
                     .stage = vk::ShaderStageFlagBits::eFragment,
-                    .module = fragment.module->module,
-                    .pName = fragment.entry.c_str()
+                    .module = getOrCreateShaderModule(*fragment.module),
+                    .pName = fragment.entry.c_str(),
+                    .pSpecializationInfo = desc.fragmentConstants.getInfo()
                 }
             );
     }
@@ -189,22 +311,12 @@ std::vector<vk::PipelineShaderStageCreateInfo> Renderer::getShaderStages(Graphic
         
         assert(geometry.module && "Geometry Stage should have a module");
 
-        if (geometry.module->module == VK_NULL_HANDLE) {
-            std::expected<ByteArray, ReadFileError> rawDataExpected = readRawFile(geometry.module->path);
-
-            if (!rawDataExpected) {
-                throw PipelineCreation_Error("Error in reading " + geometry.module->path.string() + ": " + to_string(rawDataExpected.error()));
-            }
-
-
-            geometry.module->module = CreateShaderModule(*rawDataExpected, m_device);
-        }
-        
         shaderStages.emplace_back(
                 vk::PipelineShaderStageCreateInfo {
                     .stage = vk::ShaderStageFlagBits::eGeometry,
-                    .module = geometry.module->module,
-                    .pName = geometry.entry.c_str()
+                    .module = getOrCreateShaderModule(*geometry.module),
+                    .pName = geometry.entry.c_str(),
+                    .pSpecializationInfo = desc.geometryConstants.getInfo()
                 }
             );
     }
@@ -212,124 +324,589 @@ std::vector<vk::PipelineShaderStageCreateInfo> Renderer::getShaderStages(Graphic
     return shaderStages;
 }
 
-void Renderer::CreateVulkanPipeline(PipelineDescription desc, vk::raii::Pipeline& pipeline, vk::raii::PipelineLayout& layout) const {
+namespace {
+    // Fixed-function state of a PipelineDescription, used whole by monolithic pipelines and in
+    // parts by pipeline libraries. The create infos point into the members: not copyable.
+    struct GraphicsPipelineState {
+        std::vector<vk::VertexInputBindingDescription> vertexBindings;
+        std::vector<vk::VertexInputAttributeDescription> vertexAttributes;
+        vk::PipelineVertexInputStateCreateInfo vertexInput {};
+        vk::PipelineInputAssemblyStateCreateInfo inputAssembly {};
+
+        vk::PipelineViewportStateCreateInfo viewport { .viewportCount = 1, .scissorCount = 1 };
+        vk::PipelineRasterizationStateCreateInfo rasterizer {};
+
+        vk::PipelineMultisampleStateCreateInfo multiSampling {};
+        vk::PipelineDepthStencilStateCreateInfo depthStencil {};
+
+        std::vector<vk::PipelineColorBlendAttachmentState> colorBlendAttachments;
+        vk::PipelineColorBlendStateCreateInfo colorBlending {};
+        std::vector<vk::Format> colorAttachmentFormats;
+        vk::PipelineRenderingCreateInfo rendering {};
+
+        std::vector<vk::DynamicState> dynamicStates;
+        vk::PipelineDynamicStateCreateInfo dynamicState {};
+
+        GraphicsPipelineState(const PipelineDescription& desc, const DynamicStateSupport& dynamic, vk::Format swapChainFormat);
+
+        GraphicsPipelineState(const GraphicsPipelineState&) = delete;
+        GraphicsPipelineState& operator=(const GraphicsPipelineState&) = delete;
+    };
+
+    GraphicsPipelineState::GraphicsPipelineState(const PipelineDescription& desc, const DynamicStateSupport& dynamic, vk::Format swapChainFormat) {
+        vertexInput = getVKVertexInputInfo(desc.vertexInfo, vertexBindings, vertexAttributes);
+        inputAssembly = { .topology = toVKTopology(desc.topology) };
+
+        rasterizer = getVKRasterizer(desc.rasterizer);
+
+        multiSampling.rasterizationSamples = toVKSampleCount(desc.sampleCount);
+        multiSampling.sampleShadingEnable = toVKBool(desc.sampleCount != SampleCount::ONE);
+
+        depthStencil = vk::PipelineDepthStencilStateCreateInfo {
+            .depthTestEnable       = toVKBool(desc.depthTestEnabled),                      // enable depth testing
+            .depthWriteEnable      = toVKBool(desc.depthWriteEnabled),                      // enable writing to the depth buffer
+            .depthCompareOp        = toVKCompareOp(desc.depthCompare),
+            .depthBoundsTestEnable = vk::False,                     // optional depth bounds test
+            .stencilTestEnable     = vk::False,                     // enable if you need stencil
+            .front                 = {},                            // stencil operations for front faces
+            .back                  = {},                            // stencil operations for back faces
+            .minDepthBounds        = 0.0f,                          // used if depthBoundsTestEnable = true
+            .maxDepthBounds        = 1.0f
+        };
+
+        const vk::ColorBlendEquationEXT blend = getVKBlendEquation(desc.colorBlend);
+        const vk::PipelineColorBlendAttachmentState colorBlendAttachment {
+            .blendEnable = toVKBool(desc.colorBlend != BlendMode::NONE),
+            .srcColorBlendFactor = blend.srcColorBlendFactor,
+            .dstColorBlendFactor = blend.dstColorBlendFactor,
+            .colorBlendOp        = blend.colorBlendOp,
+            .srcAlphaBlendFactor = blend.srcAlphaBlendFactor,
+            .dstAlphaBlendFactor = blend.dstAlphaBlendFactor,
+            .alphaBlendOp        = blend.alphaBlendOp,
+            .colorWriteMask = vk::ColorComponentFlagBits::eR |
+                            vk::ColorComponentFlagBits::eG |
+                            vk::ColorComponentFlagBits::eB |
+                            vk::ColorComponentFlagBits::eA
+        };
+
+        // One blend state per color attachment
+        colorBlendAttachments.assign(desc.colorAttachments.size(), colorBlendAttachment);
+        colorBlending = vk::PipelineColorBlendStateCreateInfo {
+            .logicOpEnable = vk::False,
+            .logicOp = vk::LogicOp::eCopy,
+            .attachmentCount = static_cast<uint32_t>(colorBlendAttachments.size()),
+            .pAttachments = colorBlendAttachments.data()
+        };
+
+        colorAttachmentFormats.reserve(desc.colorAttachments.size());
+        for (const ColorAttachmentFormat& format : desc.colorAttachments) {
+            if (format == ColorAttachmentFormat::SWAPCHAIN_FORMAT) colorAttachmentFormats.emplace_back(swapChainFormat);
+        }
+        rendering = vk::PipelineRenderingCreateInfo {
+            .colorAttachmentCount = static_cast<uint32_t>(colorAttachmentFormats.size()),
+            .pColorAttachmentFormats = colorAttachmentFormats.data()
+        };
+
+        dynamicStates = {
+                vk::DynamicState::eViewport,
+                vk::DynamicState::eScissor};
+
+        // The values baked above are ignored for these, Pipeline::Bind sets them instead
+        if (dynamic.enabled) {
+            dynamicStates.insert(dynamicStates.end(), {
+                    vk::DynamicState::eCullMode,
+                    vk::DynamicState::eFrontFace,
+                    vk::DynamicState::ePrimitiveTopology,
+                    vk::DynamicState::eRasterizerDiscardEnable,
+                    vk::DynamicState::eDepthTestEnable,
+                    vk::DynamicState::eDepthWriteEnable,
+                    vk::DynamicState::eDepthCompareOp });
+
+            if (dynamic.polygonMode) dynamicStates.push_back(vk::DynamicState::ePolygonModeEXT);
+            if (dynamic.depthClampEnable) dynamicStates.push_back(vk::DynamicState::eDepthClampEnableEXT);
+            if (dynamic.rasterizationSamples) dynamicStates.push_back(vk::DynamicState::eRasterizationSamplesEXT);
+            if (dynamic.colorBlend) {
+                dynamicStates.push_back(vk::DynamicState::eColorBlendEnableEXT);
+                dynamicStates.push_back(vk::DynamicState::eColorBlendEquationEXT);
+            }
+        }
+
+        dynamicState = vk::PipelineDynamicStateCreateInfo {
+            .dynamicStateCount = static_cast<uint32_t>(dynamicStates.size()), 
+            .pDynamicStates = dynamicStates.data()
+        };
+    }
+
+    constexpr vk::GraphicsPipelineLibraryFlagsEXT getLibraryFlags(PipelineLibraryPart part) {
+        switch (part) {
+            case PipelineLibraryPart::VERTEX_INPUT: return vk::GraphicsPipelineLibraryFlagBitsEXT::eVertexInputInterface;
+            case PipelineLibraryPart::PRE_RASTERIZATION: return vk::GraphicsPipelineLibraryFlagBitsEXT::ePreRasterizationShaders;
+            case PipelineLibraryPart::FRAGMENT_SHADER: return vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader;
+            case PipelineLibraryPart::FRAGMENT_OUTPUT: return vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentOutputInterface;
+        }
+
+        return {};
+    }
+}
+
+// Checked against the device's limit here, the 128 bytes Pipeline::PushConstants enforces may be exceeded by hand
+static std::vector<vk::PushConstantRange> toVKPushConstantRanges(const std::vector<PushConstantRange>& ranges, uint32_t maxSize) {
+    std::vector<vk::PushConstantRange> vkRanges;
+    vkRanges.reserve(ranges.size());
+
+    for (const PushConstantRange& range : ranges) {
+        if (range.size == 0u || range.offset % 4u != 0u || range.size % 4u != 0u || range.offset + range.size > maxSize) {
+            throw PipelineCreation_Error("Push constant range at offset " + std::to_string(range.offset) + " of " + std::to_string(range.size)
+                    + " bytes is misaligned or exceeds the device's " + std::to_string(maxSize) + " bytes");
+        }
+
+        vkRanges.emplace_back(
+                vk::PushConstantRange {
+                    .stageFlags = range.stages,
+                    .offset = range.offset,
+                    .size = range.size
+                });
+    }
+
+    return vkRanges;
+}
+
+// Graphics pipelines have no descriptor sets: the push constant ranges are the whole layout
+std::shared_ptr<vk::raii::PipelineLayout> Renderer::getPipelineLayout(const PipelineDescription& desc) const {
+    std::scoped_lock lock(m_pipelineLayoutMutex);
+
+    auto layoutItr = m_pipelineLayouts.find(desc.pushConstants);
+    if (layoutItr != m_pipelineLayouts.end()) {
+        return layoutItr->second;
+    }
+
+    const std::vector<vk::PushConstantRange> ranges = toVKPushConstantRanges(desc.pushConstants, m_physicalDevice.getProperties().limits.maxPushConstantsSize);
+
+    vk::PipelineLayoutCreateInfo layoutInfo {
+        .setLayoutCount = 0,
+        .pushConstantRangeCount = static_cast<uint32_t>(ranges.size()),
+        .pPushConstantRanges = ranges.data()
+    };
+
+    std::shared_ptr<vk::raii::PipelineLayout> layout = std::make_shared<vk::raii::PipelineLayout>(m_device, layoutInfo);
+    m_pipelineLayouts.insert({ desc.pushConstants, layout });
+
+    return layout;
+}
+
+void Renderer::CreateVulkanPipeline(PipelineDescription desc, vk::raii::Pipeline& pipeline, std::shared_ptr<vk::raii::PipelineLayout>& layout) const {
     
-    std::vector<vk::PipelineShaderStageCreateInfo> shaderStages = getShaderStages(desc.shader);
-
-    vk::PipelineVertexInputStateCreateInfo vertexInputInfo = getVKVertexInputInfo(desc.vertexInfo);
-
-    vk::PipelineInputAssemblyStateCreateInfo inputAssembly { .topology = vk::PrimitiveTopology::eTriangleList };
-    vk::PipelineViewportStateCreateInfo viewPortState { .viewportCount = 1, .scissorCount = 1 };
-
-    vk::PipelineRasterizationStateCreateInfo rasterizer = getVKRasterizer(desc.rasterizer);
-
-    vk::PipelineMultisampleStateCreateInfo multiSampling {};
-    switch (desc.sampleCount) {
-        case SampleCount::ONE:
-            multiSampling.rasterizationSamples = vk::SampleCountFlagBits::e1;
-            multiSampling.sampleShadingEnable = false;
-            break;
-        case SampleCount::TWO:
-            multiSampling.rasterizationSamples = vk::SampleCountFlagBits::e2;
-            multiSampling.sampleShadingEnable = true;
-            break;
-        case SampleCount::FOUR:
-            multiSampling.rasterizationSamples = vk::SampleCountFlagBits::e4;
-            multiSampling.sampleShadingEnable = true;
-            break;
-        case SampleCount::EIGHT:
-            multiSampling.rasterizationSamples = vk::SampleCountFlagBits::e8;
-            multiSampling.sampleShadingEnable = true;
-            break;
-        case SampleCount::SIXTEEN:
-            multiSampling.rasterizationSamples = vk::SampleCountFlagBits::e16;
-            multiSampling.sampleShadingEnable = true;
-            break;
-        case SampleCount::THIRY_TWO:
-            multiSampling.rasterizationSamples = vk::SampleCountFlagBits::e32;
-            multiSampling.sampleShadingEnable = true;
-            break;
-        case SampleCount::SIXTY_FOUR:
-            multiSampling.rasterizationSamples = vk::SampleCountFlagBits::e64;
-            multiSampling.sampleShadingEnable = true;
-            break;
-    }
-
-    vk::PipelineColorBlendAttachmentState colorBlendAttachment {
-        .colorWriteMask = vk::ColorComponentFlagBits::eR |
-                        vk::ColorComponentFlagBits::eG |
-                        vk::ColorComponentFlagBits::eB |
-                        vk::ColorComponentFlagBits::eA
+    std::vector<vk::PipelineShaderStageCreateInfo> shaderStages = getShaderStages(desc);
+
+    const GraphicsPipelineState state(desc, m_dynamicStates, m_swapChainFormat);
+
+    layout = getPipelineLayout(desc);
+
+    vk::GraphicsPipelineCreateInfo pipelineCreateInfo {
+        .pNext               = &state.rendering,
+        .stageCount          = static_cast<uint32_t>(shaderStages.size()),
+        .pStages             = shaderStages.data(),
+        .pVertexInputState   = &state.vertexInput,
+        .pInputAssemblyState = &state.inputAssembly,
+        .pViewportState      = &state.viewport,
+        .pRasterizationState = &state.rasterizer,
+        .pMultisampleState   = &state.multiSampling,
+        .pDepthStencilState  = &state.depthStencil,
+        .pColorBlendState    = &state.colorBlending,
+        .pDynamicState       = &state.dynamicState,
+        .layout              = *layout,
+        .renderPass          = nullptr
     };
 
-    vk::PipelineColorBlendStateCreateInfo colorBlending{.logicOpEnable = vk::False, .logicOp = vk::LogicOp::eCopy, .attachmentCount = 1, .pAttachments = &colorBlendAttachment};
+    pipeline = vk::raii::Pipeline(m_device, nullptr, pipelineCreateInfo);
+}
 
-    switch (desc.colorBlend) {
-        case BlendMode::NONE:
-            colorBlendAttachment.blendEnable = vk::False;
-            break;
-        case BlendMode::ONE_MINUS_SRC_ALPHA:
-            colorBlendAttachment.blendEnable = vk::True;
-
-             colorBlendAttachment.srcColorBlendFactor = vk::BlendFactor::eSrcAlpha;
-             colorBlendAttachment.dstColorBlendFactor = vk::BlendFactor::eOneMinusSrcAlpha;
-             colorBlendAttachment.colorBlendOp        = vk::BlendOp::eAdd;
-
-             colorBlendAttachment.srcAlphaBlendFactor = vk::BlendFactor::eOne;
-             colorBlendAttachment.dstAlphaBlendFactor = vk::BlendFactor::eOneMinusSrcAlpha;
-             colorBlendAttachment.alphaBlendOp        = vk::BlendOp::eAdd;
-            break;
-    }
-
-    vk::PipelineDepthStencilStateCreateInfo depthStencil {
-        .depthTestEnable       = toVKBool(desc.depthTestEnabled),                      // enable depth testing
-        .depthWriteEnable      = toVKBool(desc.depthWriteEnabled),                      // enable writing to the depth buffer
-        .depthCompareOp        = vk::CompareOp::eLess,          // default: fragments closer to camera pass
-        .depthBoundsTestEnable = vk::False,                     // optional depth bounds test
-        .stencilTestEnable     = vk::False,                     // enable if you need stencil
-        .front                 = {},                            // stencil operations for front faces
-        .back                  = {},                            // stencil operations for back faces
-        .minDepthBounds        = 0.0f,                          // used if depthBoundsTestEnable = true
-        .maxDepthBounds        = 1.0f
+template<PipelineLibraryPart part>
+std::shared_ptr<vk::raii::Pipeline> Renderer::getOrCreateLibraryPart(PipelineDescription desc, const vk::raii::PipelineLayout& layout) {
+    PipelineLibraryCache<part>& cache = [this] () -> PipelineLibraryCache<part>& {
+        if constexpr (part == PipelineLibraryPart::VERTEX_INPUT) return m_vertexInputLibraries;
+        else if constexpr (part == PipelineLibraryPart::PRE_RASTERIZATION) return m_preRasterizationLibraries;
+        else if constexpr (part == PipelineLibraryPart::FRAGMENT_SHADER) return m_fragmentShaderLibraries;
+        else return m_fragmentOutputLibraries;
+    }();
+
+    {
+        std::scoped_lock lock(m_pipelineLibraryMutex);
+        auto libraryItr = cache.find(desc);
+        if (libraryItr != cache.end()) {
+            return libraryItr->second;
+        }
+    }
+
+    const GraphicsPipelineState state(desc, m_dynamicStates, m_swapChainFormat);
+
+    // Only the stages this part compiles
+    std::vector<vk::PipelineShaderStageCreateInfo> shaderStages;
+    if constexpr (part == PipelineLibraryPart::PRE_RASTERIZATION || part == PipelineLibraryPart::FRAGMENT_SHADER) {
+        std::ranges::copy_if(getShaderStages(desc), std::back_inserter(shaderStages),
+                [] (const vk::PipelineShaderStageCreateInfo& stage) {
+                    return (stage.stage == vk::ShaderStageFlagBits::eFragment) == (part == PipelineLibraryPart::FRAGMENT_SHADER);
+                });
+    }
+
+    vk::GraphicsPipelineLibraryCreateInfoEXT libraryInfo {
+        .pNext = &state.rendering,
+        .flags = getLibraryFlags(part)
     };
 
-    std::vector<vk::DynamicState> dynamicStates = {
-		        vk::DynamicState::eViewport,
-		        vk::DynamicState::eScissor};
+    vk::GraphicsPipelineCreateInfo createInfo {
+        .pNext = &libraryInfo,
+        .flags = vk::PipelineCreateFlagBits::eLibraryKHR,
+        .stageCount = static_cast<uint32_t>(shaderStages.size()),
+        .pStages = shaderStages.data(),
+        .pDynamicState = &state.dynamicState
+    };
+
+    // Kept so the optimized link can redo the work across parts
+    if (m_optimizeLinkedPipelines) {
+        createInfo.flags |= vk::PipelineCreateFlagBits::eRetainLinkTimeOptimizationInfoEXT;
+    }
+
+    if constexpr (part == PipelineLibraryPart::VERTEX_INPUT) {
+        createInfo.pVertexInputState = &state.vertexInput;
+        createInfo.pInputAssemblyState = &state.inputAssembly;
+    }
+    else if constexpr (part == PipelineLibraryPart::PRE_RASTERIZATION) {
+        createInfo.pViewportState = &state.viewport;
+        createInfo.pRasterizationState = &state.rasterizer;
+        createInfo.layout = layout;
+    }
+    else if constexpr (part == PipelineLibraryPart::FRAGMENT_SHADER) {
+        createInfo.pMultisampleState = &state.multiSampling;
+        createInfo.pDepthStencilState = &state.depthStencil;
+        createInfo.layout = layout;
+    }
+    else {
+        createInfo.pMultisampleState = &state.multiSampling;
+        createInfo.pColorBlendState = &state.colorBlending;
+    }
+
+    std::shared_ptr<vk::raii::Pipeline> library = std::make_shared<vk::raii::Pipeline>(m_device, nullptr, createInfo);
+
+    // Another job may have compiled the same part meanwhile: everyone uses the one cached first
+    std::scoped_lock lock(m_pipelineLibraryMutex);
+    return cache.try_emplace(std::move(desc), std::move(library)).first->second;
+}
+
+void Renderer::CreateLinkedPipeline(const PipelineDescription& desc, const std::shared_ptr<PipelineHandle>& handle) {
+    // Shared with the shader parts, whose keys include the push constant ranges
+    handle->pipelineLayout = getPipelineLayout(desc);
+    const vk::raii::PipelineLayout& layout = *handle->pipelineLayout;
+
+    std::array<std::shared_ptr<vk::raii::Pipeline>, 4> parts {
+        getOrCreateLibraryPart<PipelineLibraryPart::VERTEX_INPUT>(desc, layout),
+        getOrCreateLibraryPart<PipelineLibraryPart::PRE_RASTERIZATION>(desc, layout),
+        getOrCreateLibraryPart<PipelineLibraryPart::FRAGMENT_SHADER>(desc, layout),
+        getOrCreateLibraryPart<PipelineLibraryPart::FRAGMENT_OUTPUT>(desc, layout)
+    };
+
+    // Fast link: no cross-stage optimization, usable right away
+    std::array<vk::Pipeline, 4> libraries;
+    std::ranges::transform(parts, libraries.begin(), [] (const auto& part) { return **part; });
+
+    vk::PipelineLibraryCreateInfoKHR linkInfo {
+        .libraryCount = static_cast<uint32_t>(libraries.size()),
+        .pLibraries = libraries.data()
+    };
+
+    handle->pipeline = vk::raii::Pipeline(m_device, nullptr,
+            vk::GraphicsPipelineCreateInfo {
+                .pNext = &linkInfo,
+                .layout = layout
+            });
+
+    if (!m_optimizeLinkedPipelines) return;
+
+    // The optimized link runs in the background and replaces the fast one between frames.
+    // It holds on to the layout: the handle may be destroyed first.
+    std::packaged_task<vk::raii::Pipeline()> optimizeTask(
+            [&device = m_device, parts = std::move(parts), libraries, layout = handle->pipelineLayout] () {
+                vk::PipelineLibraryCreateInfoKHR optimizedLinkInfo {
+                    .libraryCount = static_cast<uint32_t>(libraries.size()),
+                    .pLibraries = libraries.data()
+                };
+
+                return vk::raii::Pipeline(device, nullptr,
+                        vk::GraphicsPipelineCreateInfo {
+                            .pNext = &optimizedLinkInfo,
+                            .flags = vk::PipelineCreateFlagBits::eLinkTimeOptimizationEXT,
+                            .layout = *layout
+                        });
+            });
+
+    {
+        std::scoped_lock lock(m_optimizedLinkMutex);
+        m_optimizedLinks.push_back({ handle, optimizeTask.get_future() });
+    }
+    m_jobs.SubmitBackground(
+            [task = std::move(optimizeTask)] () mutable {
+                task();
+            }, &m_backgroundJobs);
+}
+
+void Renderer::CollectOptimizedPipelines() {
+    std::scoped_lock lock(m_optimizedLinkMutex);
+
+    std::erase_if(m_optimizedLinks,
+            [this] (OptimizedLink& link) {
+                if (link.pipeline.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+
+                try {
+                    vk::raii::Pipeline optimized = link.pipeline.get();
+
+                    // Gone if the pipeline was destroyed meanwhile, the optimized one is then dropped unused
+                    if (std::shared_ptr<PipelineHandle> handle = link.handle.lock()) {
+                        Retire(std::move(handle->pipeline));
+                        handle->pipeline = std::move(optimized);
+                    }
+                }
+                catch (const std::exception& e) {
+                    DEBUG_PRINT(std::string("Optimized pipeline link failed, keeping the fast link: ") + e.what());
+                }
+
+                return true;
+            });
+}
 
-	vk::PipelineDynamicStateCreateInfo dynamicState {
-        .dynamicStateCount = static_cast<uint32_t>(dynamicStates.size()), 
-        .pDynamicStates = dynamicStates.data()
+void Renderer::CreateShaderObjects(const PipelineDescription& desc, PipelineHandle& handle) const {
+    struct StageSource {
+        vk::ShaderStageFlagBits stage;
+        ShaderModule* module;
+        const std::string* entry;
+        const SpecializationConstants* constants;
     };
 
-    std::vector<vk::Format> colorAttachmentFormats;
-    colorAttachmentFormats.reserve(desc.colorAttachments.size());
+    std::vector<StageSource> stages;
+    stages.push_back({ vk::ShaderStageFlagBits::eVertex, desc.shader.vertexStage.module.get(), &desc.shader.vertexStage.entry, &desc.vertexConstants });
+    if (desc.shader.geometryStage) {
+        stages.push_back({ vk::ShaderStageFlagBits::eGeometry, desc.shader.geometryStage->module.get(), &desc.shader.geometryStage->entry, &desc.geometryConstants });
+    }
+    stages.push_back({ vk::ShaderStageFlagBits::eFragment, desc.shader.fragmentStage.module.get(), &desc.shader.fragmentStage.entry, &desc.fragmentConstants });
+
+    // Read once per module, shared with its vk::ShaderModule and every other variant
+    std::vector<std::shared_ptr<const ByteArray>> codes;
+    codes.reserve(stages.size());
+    for (const StageSource& source : stages) {
+        assert(source.module && "Every shader stage should have a module");
+        codes.push_back(getShaderCode(*source.module));
+    }
+
+    // Must match the layout's ranges for the pushes to reach the shaders
+    const std::vector<vk::PushConstantRange> pushConstantRanges = toVKPushConstantRanges(desc.pushConstants, m_physicalDevice.getProperties().limits.maxPushConstantsSize);
+
+    std::vector<vk::ShaderCreateInfoEXT> createInfos;
+    createInfos.reserve(stages.size());
+    for (size_t i = 0; i < stages.size(); ++i) {
+        const ByteArray& code = *codes[i];
+
+        createInfos.emplace_back(
+                vk::ShaderCreateInfoEXT {
+                    .flags = vk::ShaderCreateFlagBitsEXT::eLinkStage,
+                    .stage = stages[i].stage,
+                    .nextStage = (i + 1 < stages.size()) ? vk::ShaderStageFlags(stages[i + 1].stage) : vk::ShaderStageFlags{},
+                    .codeType = vk::ShaderCodeTypeEXT::eSpirv,
+                    .codeSize = code.size(),
+                    .pCode = code.data(),
+                    .pName = stages[i].entry->c_str(),
+                    .pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size()),
+                    .pPushConstantRanges = pushConstantRanges.data(),
+                    .pSpecializationInfo = stages[i].constants->getInfo()
+                });
+    }
+
+    handle.shaders = m_device.createShadersEXT(createInfos);
+
+    handle.shaderStages.clear();
+    handle.shaderHandles.clear();
+    for (size_t i = 0; i < stages.size(); ++i) {
+        handle.shaderStages.push_back(stages[i].stage);
+        handle.shaderHandles.push_back(*handle.shaders[i]);
+    }
+
+    // Kept so descriptors and push constants have a layout to refer to
+    handle.pipelineLayout = getPipelineLayout(desc);
+}
+
+// Safe on job threads: the backend is fixed once pipelines exist
+std::shared_ptr<PipelineHandle> Renderer::CreatePipelineHandle(const PipelineDescription& desc) {
+    std::shared_ptr<PipelineHandle> handle = std::make_shared<PipelineHandle>();
+
+    if (m_dynamicStates.shaderObject) CreateShaderObjects(desc, *handle);
+    else if (m_pipelineLibraries) CreateLinkedPipeline(desc, handle);
+    else CreateVulkanPipeline(desc, handle->pipeline, handle->pipelineLayout);
+
+    return handle;
+}
+
+std::shared_ptr<Pipeline> Renderer::getOrCreatePipeline(const PipelineDescription& desc) {
+    std::shared_ptr<Pipeline> pipeline = std::make_shared<Pipeline>(desc.name);
+
+    auto handleItr = m_pipelineRegistry.find(desc);
+    if (handleItr != m_pipelineRegistry.end()) {
+        pipeline->handle = handleItr->second;
+    }
+    else {
+        pipeline->handle = CreatePipelineHandle(desc);
+        m_pipelineRegistry.insert({ desc, pipeline->handle });
+    }
+
+    if (m_dynamicStates.enabled) {
+        pipeline->dynamicState = getDynamicPipelineState(desc);
+        pipeline->stateCache = &m_dynamicStateCache;
+    }
+
+    m_pipelines.push_back(pipeline);
+    return pipeline;
+}
+
+static vk::DescriptorType toVKDescriptorType(DescriptorType type) {
+    switch (type) {
+        case DescriptorType::STORAGE_IMAGE: return vk::DescriptorType::eStorageImage;
+        case DescriptorType::STORAGE_BUFFER: return vk::DescriptorType::eStorageBuffer;
+        case DescriptorType::UNIFORM_BUFFER: return vk::DescriptorType::eUniformBuffer;
+    }
+
+    return {};
+}
 
-    for (const ColorAttachmentFormat& format : desc.colorAttachments) {
-        if (format == ColorAttachmentFormat::SWAPCHAIN_FORMAT) colorAttachmentFormats.emplace_back(m_SwapChainSurfaceFormat.format);
+void Renderer::CreateComputePipeline(ComputePipelineDescription desc, PipelineHandle& handle) const {
+    ComputeStage& compute = desc.shader.computeStage;
+
+    assert(compute.module && "Compute Stage should have a module");
+
+    if (!desc.bindings.empty() && !m_pushDescriptorSupported) {
+        throw PipelineCreation_Error("Compute pipeline bindings need VK_KHR_push_descriptor, which the device does not support");
     }
 
+    std::vector<vk::DescriptorSetLayoutBinding> bindings;
+    bindings.reserve(desc.bindings.size());
+    for (const DescriptorBinding& binding : desc.bindings) {
+        bindings.emplace_back(
+                vk::DescriptorSetLayoutBinding {
+                    .binding = binding.binding,
+                    .descriptorType = toVKDescriptorType(binding.type),
+                    .descriptorCount = 1u,
+                    .stageFlags = vk::ShaderStageFlagBits::eCompute
+                });
+    }
+
+    std::vector<vk::DescriptorSetLayout> setLayouts;
+    if (!bindings.empty()) {
+        handle.descriptorSetLayout = vk::raii::DescriptorSetLayout(m_device,
+                vk::DescriptorSetLayoutCreateInfo {
+                    .flags = vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR,
+                    .bindingCount = static_cast<uint32_t>(bindings.size()),
+                    .pBindings = bindings.data()
+                });
+        setLayouts.push_back(*handle.descriptorSetLayout);
+    }
+
+    // Set 0 is this pipeline's own, so compute layouts are not shared
+    const std::vector<vk::PushConstantRange> pushConstantRanges = toVKPushConstantRanges(desc.pushConstants, m_physicalDevice.getProperties().limits.maxPushConstantsSize);
+
     vk::PipelineLayoutCreateInfo layoutInfo {
-        .setLayoutCount = 0,
-        .pushConstantRangeCount = 0,
+        .setLayoutCount = static_cast<uint32_t>(setLayouts.size()),
+        .pSetLayouts = setLayouts.data(),
+        .pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size()),
+        .pPushConstantRanges = pushConstantRanges.data()
+    };
+    handle.pipelineLayout = std::make_shared<vk::raii::PipelineLayout>(m_device, layoutInfo);
+    handle.bindPoint = vk::PipelineBindPoint::eCompute;
+
+    vk::ComputePipelineCreateInfo createInfo {
+        .stage = {
+            .stage = vk::ShaderStageFlagBits::eCompute,
+            .module = getOrCreateShaderModule(*compute.module),
+            .pName = compute.entry.c_str(),
+            .pSpecializationInfo = desc.constants.getInfo()
+        },
+        .layout = *handle.pipelineLayout
+    };
+
+    handle.pipeline = vk::raii::Pipeline(m_device, nullptr, createInfo);
+}
+
+// Compute pipelines have no dynamic state and are always real pipelines, shader objects or not
+std::shared_ptr<Pipeline> Renderer::getOrCreatePipeline(const ComputePipelineDescription& desc) {
+    std::shared_ptr<Pipeline> pipeline = std::make_shared<Pipeline>(desc.name);
+
+    auto handleItr = m_computePipelineRegistry.find(desc);
+    if (handleItr != m_computePipelineRegistry.end()) {
+        pipeline->handle = handleItr->second;
+    }
+    else {
+        pipeline->handle = std::make_shared<PipelineHandle>();
+        CreateComputePipeline(desc, *pipeline->handle);
+
+        m_computePipelineRegistry.insert({ desc, pipeline->handle });
+    }
+
+    m_pipelines.push_back(pipeline);
+    return pipeline;
+}
+
+void Renderer::EnableDynamicPipelineState(bool enable) {
+    assert(m_pipelines.empty() && "Pipeline state mode must be chosen before any pipeline is created");
+
+    m_dynamicStates = enable ? m_supportedDynamicStates : DynamicStateSupport{};
+    m_dynamicStateCache = DynamicStateCache(m_dynamicStates);
+
+    ResetPipelineRegistries();
+}
+
+bool Renderer::EnableShaderObjects(bool enable) {
+    assert(m_pipelines.empty() && "Pipeline backend must be chosen before any pipeline is created");
+
+    if (enable && !m_shaderObjectsSupported) {
+        return false;
+    }
+
+    if (!enable) {
+        EnableDynamicPipelineState(false);
+        return true;
+    }
+
+    // With shader objects nothing is baked: every state is set at bind time
+    m_dynamicStates = DynamicStateSupport {
+        .enabled = true,
+        .polygonMode = true,
+        .depthClampEnable = true,
+        .rasterizationSamples = true,
+        .colorBlend = true,
+        .shaderObject = true
     };
+    m_dynamicStateCache = DynamicStateCache(m_dynamicStates);
+    m_pipelineLibraries = false;
+
+    ResetPipelineRegistries();
+
+    return true;
+}
+
+bool Renderer::EnablePipelineLibraries(bool enable, bool optimizeInBackground) {
+    assert(m_pipelines.empty() && "Pipeline backend must be chosen before any pipeline is created");
+
+    if (enable && (!m_pipelineLibrariesSupported || m_dynamicStates.shaderObject)) {
+        return false;
+    }
+
+    m_pipelineLibraries = enable;
+    m_optimizeLinkedPipelines = enable && optimizeInBackground;
+
+    return true;
+}
+
+// Keys depend on which states are dynamic
+void Renderer::ResetPipelineRegistries() {
+    m_pipelineRegistry = PipelineRegistry(0u, PipelineDescriptionHash{ m_dynamicStates }, PipelineDescriptionEqual{ m_dynamicStates });
 
-    layout = vk::raii::PipelineLayout(m_device, layoutInfo);
-
-	vk::StructureChain<vk::GraphicsPipelineCreateInfo, vk::PipelineRenderingCreateInfo> pipelineCreateInfoChain = {
-	    {.stageCount          = static_cast<uint32_t>(shaderStages.size()),
-	     .pStages             = shaderStages.data(),
-	     .pVertexInputState   = &vertexInputInfo,
-	     .pInputAssemblyState = &inputAssembly,
-	     .pViewportState      = &viewPortState,
-	     .pRasterizationState = &rasterizer,
-	     .pMultisampleState   = &multiSampling,
-         .pDepthStencilState  = &depthStencil,
-	     .pColorBlendState    = &colorBlending,
-	     .pDynamicState       = &dynamicState,
-	     .layout              = layout,
-	     .renderPass          = nullptr},
-	    {.colorAttachmentCount = static_cast<uint32_t>(colorAttachmentFormats.size()), .pColorAttachmentFormats = colorAttachmentFormats.data()}};
-
-    pipeline = vk::raii::Pipeline(m_device, nullptr, pipelineCreateInfoChain.get<vk::GraphicsPipelineCreateInfo>());
+    m_vertexInputLibraries = decltype(m_vertexInputLibraries)(0u, { m_dynamicStates }, { m_dynamicStates });
+    m_preRasterizationLibraries = decltype(m_preRasterizationLibraries)(0u, { m_dynamicStates }, { m_dynamicStates });
+    m_fragmentShaderLibraries = decltype(m_fragmentShaderLibraries)(0u, { m_dynamicStates }, { m_dynamicStates });
+    m_fragmentOutputLibraries = decltype(m_fragmentOutputLibraries)(0u, { m_dynamicStates }, { m_dynamicStates });
 }
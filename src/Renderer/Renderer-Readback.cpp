@@ -0,0 +1,268 @@
+#include "pch.hpp"
+#include "Renderer/Renderer.hpp"
+
+#include "Utils.hpp"
+#include "Renderer/Renderer-Exceptions.hpp"
+#include "Renderer/RenderGraph/RenderGraph.hpp"
+#include "Renderer/RenderGraph/ImageResource.hpp"
+#include "Renderer/RenderGraph/BarrierBatch.hpp"
+
+// Bytes per texel of the formats readbacks handle, 0 for the others (compressed, depth/stencil, ...)
+static uint32_t getTexelSize(vk::Format format) {
+    switch (format) {
+        case vk::Format::eR8Unorm:
+            return 1u;
+        case vk::Format::eR8G8Unorm:
+        case vk::Format::eR16Sfloat:
+            return 2u;
+        case vk::Format::eR8G8B8A8Unorm:
+        case vk::Format::eR8G8B8A8Srgb:
+        case vk::Format::eB8G8R8A8Unorm:
+        case vk::Format::eB8G8R8A8Srgb:
+        case vk::Format::eA2B10G10R10UnormPack32:
+        case vk::Format::eA2R10G10B10UnormPack32:
+        case vk::Format::eB10G11R11UfloatPack32:
+        case vk::Format::eR32Sfloat:
+            return 4u;
+        case vk::Format::eR16G16B16A16Sfloat:
+        case vk::Format::eR32G32Sfloat:
+            return 8u;
+        case vk::Format::eR32G32B32A32Sfloat:
+            return 16u;
+        default:
+            return 0u;
+    }
+}
+
+ReadbackId Renderer::StartReadback(const std::string& resource, ReadbackCallback callback, bool continuous, OutputId output) {
+    assert(callback && "A readback needs a callback");
+
+    // The surface decides whether the swapchain images can be copied from, see CreateSwapChain()
+    const RenderOutput& target = *m_outputs.at(output);
+    if (resource == "BackBuffer" && !(target.swapChainUsage & vk::ImageUsageFlagBits::eTransferSrc)) {
+        return INVALID_READBACK_ID;
+    }
+
+    std::scoped_lock lock(m_readbackMutex);
+    const ReadbackId id = m_nextReadbackId++;
+    m_readbackRequests.push_back({
+            .id = id,
+            .output = output,
+            .resource = resource,
+            .callback = std::make_shared<ReadbackCallback>(std::move(callback)),
+            .continuous = continuous
+        });
+
+    return id;
+}
+
+// Captures already recorded are still delivered
+void Renderer::StopReadback(ReadbackId id) {
+    std::scoped_lock lock(m_readbackMutex);
+    std::erase_if(m_readbackRequests,
+            [id] (const ReadbackRequest& request) {
+                return request.id == id;
+            });
+}
+
+ReadbackStats Renderer::getReadbackStats() const {
+    return ReadbackStats {
+        .completed = m_readbacksCompleted.load(std::memory_order_relaxed),
+        .dropped = m_readbacksDropped.load(std::memory_order_relaxed)
+    };
+}
+
+// A free slot big enough, a free one regrown, or a new one while the ring is not full
+Renderer::ReadbackSlot* Renderer::AcquireReadbackSlot(VkDeviceSize size) {
+    auto isFree = [] (const std::unique_ptr<ReadbackSlot>& slot) {
+        return !slot->pending && !slot->delivering.load(std::memory_order_acquire);
+    };
+
+    auto fitting = std::ranges::find_if(m_readbackSlots,
+            [&isFree, size] (const std::unique_ptr<ReadbackSlot>& slot) {
+                return isFree(slot) && slot->size >= size;
+            });
+    if (fitting != m_readbackSlots.end()) return fitting->get();
+
+    ReadbackSlot* slot = nullptr;
+    auto free = std::ranges::find_if(m_readbackSlots, isFree);
+    if (free != m_readbackSlots.end()) {
+        // Free means its last copy has completed and been delivered: nothing uses the buffer anymore
+        slot = free->get();
+        DestroyReadbackBuffer(*slot);
+    }
+    else if (m_readbackSlots.size() < READBACK_RING_SIZE) {
+        slot = m_readbackSlots.emplace_back(std::make_unique<ReadbackSlot>()).get();
+    }
+    else {
+        return nullptr;
+    }
+
+    AllocateReadbackBuffer(*slot, size);
+    return slot;
+}
+
+// Same memory as BufferMemory::READBACK
+void Renderer::AllocateReadbackBuffer(ReadbackSlot& slot, VkDeviceSize size) {
+    vk::BufferCreateInfo bufferInfo {
+        .size = size,
+        .usage = vk::BufferUsageFlagBits::eTransferDst,
+        .sharingMode = vk::SharingMode::eExclusive
+    };
+
+    VmaAllocationCreateInfo allocInfo{};
+    allocInfo.usage = VMA_MEMORY_USAGE_AUTO;
+    allocInfo.flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+
+    VmaAllocationInfo allocationInfo {};
+    if (vmaCreateBuffer(m_allocator, &static_cast<const VkBufferCreateInfo&>(bufferInfo), &allocInfo, &slot.buffer, &slot.allocation, &allocationInfo) != VK_SUCCESS) {
+        throw CreateBufferError("Failed to allocate a readback buffer");
+    }
+    m_memoryTracker.Track(m_allocator, slot.allocation, MemoryCategory::TRANSFER_BUFFERS);
+
+    VkMemoryPropertyFlags memoryFlags = 0u;
+    vmaGetAllocationMemoryProperties(m_allocator, slot.allocation, &memoryFlags);
+
+    slot.size = size;
+    slot.mapped = allocationInfo.pMappedData;
+    slot.hostCoherent = memoryFlags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+}
+
+// Only once no frame or callback uses it
+void Renderer::DestroyReadbackBuffer(ReadbackSlot& slot) {
+    if (!slot.buffer) return;
+
+    m_memoryTracker.Untrack(m_allocator, slot.allocation);
+    vmaDestroyBuffer(m_allocator, slot.buffer, slot.allocation);
+
+    slot.buffer = VK_NULL_HANDLE;
+    slot.allocation = {};
+    slot.size = 0u;
+    slot.mapped = nullptr;
+}
+
+// After the graph's passes, before BackBuffer goes to present
+void Renderer::RecordReadbacks(RenderOutput& output, const vk::raii::CommandBuffer& buffer, RenderGraph::BarrierBatch& barriers) {
+    auto outputItr = std::ranges::find_if(m_outputs,
+            [&output] (const std::unique_ptr<RenderOutput>& other) {
+                return other.get() == &output;
+            });
+    const OutputId outputId = static_cast<OutputId>(std::distance(m_outputs.begin(), outputItr));
+
+    std::vector<ReadbackRequest> requests;
+    {
+        std::scoped_lock lock(m_readbackMutex);
+        for (const ReadbackRequest& request : m_readbackRequests) {
+            if (request.output == outputId) requests.push_back(request);
+        }
+
+        // One-shot requests are taken now, recorded or not
+        std::erase_if(m_readbackRequests,
+                [outputId] (const ReadbackRequest& request) {
+                    return request.output == outputId && !request.continuous;
+                });
+    }
+    if (requests.empty()) return;
+
+    RenderGraph::RenderGraph& renderGraph = *output.renderGraph;
+
+    bool anyCopy = false;
+    for (const ReadbackRequest& request : requests) {
+        auto resource = renderGraph.getResource(request.resource);
+        if (!resource) {
+            DEBUG_PRINT("Readback: no image " + request.resource + " in the render graph");
+            continue;
+        }
+
+        ImageResource& image = resource.value().get();
+        if (!image.image) continue;     // Not allocated this frame
+
+        const uint32_t texelSize = getTexelSize(image.format);
+        if (!(image.usage & vk::ImageUsageFlagBits::eTransferSrc) || image.samples != vk::SampleCountFlagBits::e1 || texelSize == 0u) {
+            DEBUG_PRINT("Readback: " + request.resource + " needs eTransferSrc usage, one sample and a color format");
+            continue;
+        }
+
+        const vk::Extent2D extent = image.getRenderExtent();
+        const VkDeviceSize size = static_cast<VkDeviceSize>(extent.width) * extent.height * texelSize;
+
+        ReadbackSlot* slot = AcquireReadbackSlot(size);
+        if (!slot) {
+            ++m_readbacksDropped;
+            continue;
+        }
+
+        const vk::ImageSubresourceRange range { vk::ImageAspectFlagBits::eColor, 0u, 1u, 0u, 1u };
+        barriers.Transition(image, range, vk::ImageLayout::eTransferSrcOptimal);
+        barriers.Flush(buffer);
+
+        buffer.copyImageToBuffer(image.image, vk::ImageLayout::eTransferSrcOptimal, slot->buffer,
+                vk::BufferImageCopy {
+                    .bufferOffset = 0u,
+                    .bufferRowLength = 0u,
+                    .bufferImageHeight = 0u,
+                    .imageSubresource = { vk::ImageAspectFlagBits::eColor, 0u, 0u, 1u },
+                    .imageOffset = { 0, 0, 0 },
+                    .imageExtent = { extent.width, extent.height, 1u }
+                });
+        anyCopy = true;
+
+        slot->pending = true;
+        slot->frame = frameCount;
+        slot->callback = request.callback;
+        slot->image = ReadbackImage {
+            .resource = request.resource,
+            .output = outputId,
+            .frame = frameCount,
+            .extent = extent,
+            .format = image.format,
+            .rowPitch = extent.width * texelSize
+        };
+    }
+
+    if (!anyCopy) return;
+
+    vk::MemoryBarrier2 toHost {
+        .srcStageMask = vk::PipelineStageFlagBits2::eCopy,
+        .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+        .dstStageMask = vk::PipelineStageFlagBits2::eHost,
+        .dstAccessMask = vk::AccessFlagBits2::eHostRead
+    };
+    buffer.pipelineBarrier2({ .memoryBarrierCount = 1u, .pMemoryBarriers = &toHost });
+}
+
+// Same completion rule as CollectRetiredResources(): every frame up to
+// (frameCount - MAX_FRAMES_IN_FLIGHT) has completed
+void Renderer::CollectReadbacks() {
+    if (frameCount < MAX_FRAMES_IN_FLIGHT) return;
+    const DeletionQueue::FrameNumber completedFrame = frameCount - MAX_FRAMES_IN_FLIGHT;
+
+    for (const std::unique_ptr<ReadbackSlot>& slotPtr : m_readbackSlots) {
+        ReadbackSlot& slot = *slotPtr;
+        if (!slot.pending || slot.frame > completedFrame) continue;
+
+        const size_t size = static_cast<size_t>(slot.image.rowPitch) * slot.image.extent.height;
+        if (!slot.hostCoherent) vmaInvalidateAllocation(m_allocator, slot.allocation, 0u, size);
+        slot.image.pixels = std::span(static_cast<const std::byte*>(slot.mapped), size);
+
+        slot.pending = false;
+        slot.delivering.store(true, std::memory_order_release);
+
+        m_jobs.SubmitBackground(
+                [this, &slot] () {
+                    try {
+                        (*slot.callback)(slot.image);
+                        ++m_readbacksCompleted;
+                    }
+                    catch (const std::exception& e) {
+                        DEBUG_PRINT("Readback " + slot.image.resource + " callback failed: " + e.what());
+                    }
+                    catch (...) {
+                        DEBUG_PRINT("Readback " + slot.image.resource + " callback failed");
+                    }
+
+                    slot.callback.reset();
+                    slot.delivering.store(false, std::memory_order_release);
+                }, &m_backgroundJobs);
+    }
+}
@@ -5,38 +5,143 @@
 #include "Renderer/Pipeline/Pipeline.hpp"
 #include "Renderer/Pipeline/PipelineDescription.hpp"
 
-void Renderer::SetRenderGraph(std::unique_ptr<RenderGraph::RenderGraph> renderGraph) {
-    m_renderGraph = std::move(renderGraph);
+#include "Utils.hpp"
 
-    m_renderGraph->AddResource(ImageResource {
+void Renderer::SetRenderGraph(std::unique_ptr<RenderGraph::RenderGraph> renderGraph, OutputId outputId) {
+    RenderOutput& output = *m_outputs.at(outputId);
+    output.renderGraph = std::move(renderGraph);
+    AddBackBuffer(output);
+
+    UpdateRenderGraph(*output.renderGraph);
+}
+
+void Renderer::SetRenderGraph(std::unique_ptr<RenderGraph::RenderGraph> renderGraph, const std::filesystem::path& compiledGraphPath, OutputId outputId) {
+    RenderOutput& output = *m_outputs.at(outputId);
+    output.renderGraph = std::move(renderGraph);
+    AddBackBuffer(output);
+
+    const PipelineDescriptionHash pipelineHash { .dynamicStates = m_dynamicStates };
+    const uint64_t descriptionHash = output.renderGraph->getDescriptionHash(pipelineHash);
+
+    bool loaded = false;
+    if (auto blob = readRawFile(compiledGraphPath)) {
+        loaded = output.renderGraph->LoadCompiled(blob.value(), descriptionHash) == RenderGraph::LoadCompiledResult::OK;
+    }
+
+    // Compile() is a no-op on a loaded graph, this only prepares the passes
+    UpdateRenderGraph(*output.renderGraph);
+
+    if (!loaded) {
+        DEBUG_PRINT("Render Graph: compiled graph missing or outdated, rewriting " + compiledGraphPath.string());
+        if (!writeRawFile(compiledGraphPath, output.renderGraph->SerializeCompiled(descriptionHash, pipelineHash))) {
+            DEBUG_PRINT("Render Graph: failed to write " + compiledGraphPath.string());
+        }
+    }
+}
+
+void Renderer::AddBackBuffer(RenderOutput& output) {
+    output.renderGraph->AddResource(ImageResource {
                 .name = "BackBuffer",
-                .format = m_SwapChainSurfaceFormat.format,
-                .extent = m_swapChainExtent,
-                .usage = vk::ImageUsageFlagBits::eColorAttachment,
+                .format = output.surfaceFormat.format,
+                .extent = output.swapChainExtent,
+                .usage = output.swapChainUsage,
+                .external = true,
             });
+}
+
+RenderGraph::RenderGraph& Renderer::getRenderGraph(OutputId outputId) {
+    const RenderOutput& output = *m_outputs.at(outputId);
+    if (!output.renderGraph) {
+        throw std::runtime_error("Render Graph not set: call Renderer::SetRenderGraph()");
+    }
 
-    m_renderGraph->Compile();
+    return *output.renderGraph;
+}
 
-    for (std::unique_ptr<RenderGraph::RenderPass>& pass : m_renderGraph->getOrderedNodesUnsafe()) {
-        pass->renderer = this;
+void Renderer::UpdateRenderGraph(RenderGraph::RenderGraph& renderGraph) {
+    if (renderGraph.Compile() != RenderGraph::CompileResult::OK) {
+        DEBUG_PRINT("Render Graph: some passes read resources nothing produces, they are skipped");
+    }
 
-        for (const PipelineDescription& pipelineDesc : pass->getPipelineDescriptions()) {
-            m_pipelines.emplace_back(std::make_shared<Pipeline>(pipelineDesc.name));
+    // Passes that were already prepared keep their pipelines and buffers
+    PrecompilePipelines(renderGraph.getNodes());
+    for (const std::unique_ptr<RenderGraph::RenderPass>& pass : renderGraph.getNodes()) {
+        if (pass->renderer == nullptr) {
+            PrepareRenderPass(*pass);
+        }
+    }
 
-            CreateVulkanPipeline(pipelineDesc, m_pipelines.back()->pipeline, m_pipelines.back()->pipelineLayout);
+    for (std::unique_ptr<RenderGraph::RenderPass>& pass : renderGraph.TakeRemovedNodes()) {
+        ReleaseRenderPass(std::move(pass));
+    }
 
-		    pass->pipelines.insert({ pipelineDesc.name, m_pipelines.back()});
+    for (ImageResource& resource : renderGraph.TakeRemovedResources()) {
+        ReleaseGraphImage(resource);
+    }
+    for (BufferResource& resource : renderGraph.TakeRemovedBuffers()) {
+        ReleaseGraphBuffer(resource);
+    }
+
+    AllocateGraphImages(renderGraph);
+    AllocateGraphBuffers(renderGraph);
+}
+
+void Renderer::PrepareRenderPass(RenderGraph::RenderPass& pass) {
+    pass.renderer = this;
+
+    for (const PipelineDescription& pipelineDesc : pass.getPipelineDescriptions()) {
+        if (!pipelineDesc.async) {
+            pass.pipelines.insert({ pipelineDesc.name, getOrCreatePipeline(pipelineDesc) });
+            continue;
         }
-        for (const BufferDescription& bufferDesc : pass->getBufferDescriptions()) {
-            std::shared_ptr<Buffer> buffer;
-
-            switch (bufferDesc.usage) {
-                case BufferUsage::VERTEX_BUFFER: buffer = CreateBuffer<VertexBuffer>(bufferDesc); break;
-                case BufferUsage::UNIFORM_BUFFER: buffer = CreateBuffer<UniformBuffer>(bufferDesc); break;
-                case BufferUsage::TRANSFER_BUFFER: buffer = CreateBuffer<TransferBuffer>(bufferDesc); break;
-            }
-            
-		    pass->buffers.insert({ bufferDesc.name, buffer });
+
+        std::shared_ptr<const Pipeline> fallback;
+        if (!pipelineDesc.fallback.empty()) {
+            auto fallbackItr = pass.pipelines.find(pipelineDesc.fallback);
+            assert(fallbackItr != pass.pipelines.end() && "A fallback pipeline must be declared before the pipelines using it");
+            fallback = fallbackItr->second;
         }
+        pass.pipelines.insert({ pipelineDesc.name, RequestPipeline(pipelineDesc, std::move(fallback)) });
+    }
+    for (const ComputePipelineDescription& pipelineDesc : pass.getComputePipelineDescriptions()) {
+        pass.pipelines.insert({ pipelineDesc.name, getOrCreatePipeline(pipelineDesc) });
     }
+    for (const BufferDescription& bufferDesc : pass.getBufferDescriptions()) {
+        std::shared_ptr<Buffer> buffer;
+
+        switch (bufferDesc.usage) {
+            case BufferUsage::VERTEX_BUFFER: buffer = CreateBuffer<VertexBuffer>(bufferDesc); break;
+            case BufferUsage::UNIFORM_BUFFER: buffer = CreateBuffer<UniformBuffer>(bufferDesc); break;
+            case BufferUsage::TRANSFER_BUFFER: buffer = CreateBuffer<TransferBuffer>(bufferDesc); break;
+            case BufferUsage::STORAGE_BUFFER: buffer = CreateBuffer<StorageBuffer>(bufferDesc); break;
+        }
+        
+        pass.buffers.insert({ bufferDesc.name, buffer });
+    }
+}
+
+void Renderer::ReleaseRenderPass(std::unique_ptr<RenderGraph::RenderPass> pass) {
+    for (const auto& [name, pipeline] : pass->pipelines) {
+        auto pipelineItr = std::ranges::find_if(m_pipelines,
+                [&pipeline] (const std::shared_ptr<Pipeline>& owned) {
+                    return owned.get() == pipeline.get();
+                });
+        if (pipelineItr != m_pipelines.end()) {
+            DestroyPipeline(std::shared_ptr<Pipeline>(*pipelineItr));
+        }
+    }
+
+    std::vector<std::shared_ptr<Buffer>> buffers;
+    for (const auto& [name, buffer] : pass->buffers) {
+        auto bufferItr = std::ranges::find_if(m_buffers,
+                [&buffer] (const std::shared_ptr<Buffer>& owned) {
+                    return owned.get() == buffer.get();
+                });
+        if (bufferItr != m_buffers.end()) {
+            buffers.push_back(*bufferItr);
+        }
+    }
+    DestroyBuffers(buffers);
+
+    Retire(std::move(pass));
 }
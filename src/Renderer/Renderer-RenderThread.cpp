@@ -0,0 +1,81 @@
+#include "pch.hpp"
+#include "Renderer/Renderer.hpp"
+#include "Utils.hpp"
+
+void Renderer::StartRenderThread() {
+    assert(!m_renderThread.joinable() && "The render thread is already running");
+
+    m_renderThreadError = nullptr;
+    m_renderThreadFailed = false;
+
+    m_renderThread = std::jthread(
+            [this] (std::stop_token stopToken) {
+                try {
+                    while (!stopToken.stop_requested()) {
+                        const DeletionQueue::FrameNumber submitted = frameCount;
+                        Render();
+
+                        // Nothing was presented (every output minimized): wait for a size instead of spinning
+                        if (frameCount == submitted) {
+                            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                        }
+                    }
+                }
+                catch (...) {
+                    m_renderThreadError = std::current_exception();
+                    m_renderThreadFailed = true;
+                }
+            });
+}
+
+void Renderer::StopRenderThread() {
+    if (!m_renderThread.joinable()) return;
+
+    m_renderThread.request_stop();
+    m_renderThread.join();
+
+    if (m_renderThreadError) {
+        std::rethrow_exception(std::exchange(m_renderThreadError, nullptr));
+    }
+}
+
+void Renderer::Enqueue(std::move_only_function<void()> command) {
+    if (!m_renderThread.joinable()) {
+        command();
+        return;
+    }
+
+    std::scoped_lock lock(m_renderCommandMutex);
+    m_renderCommands.push_back(std::move(command));
+}
+
+// Render thread, before anything of the frame reads renderer state
+void Renderer::RunRenderCommands() {
+    std::vector<std::move_only_function<void()>> commands;
+    {
+        std::scoped_lock lock(m_renderCommandMutex);
+        commands.swap(m_renderCommands);
+    }
+
+    for (std::move_only_function<void()>& command : commands) {
+        command();
+    }
+}
+
+// Once per snapshot: a snapshot used by several frames is not written again. Always staged, never
+// written in place: frames in flight may still read the previous contents.
+void Renderer::WriteSnapshotUniforms(const FrameSnapshot& snapshot) {
+    for (const auto& [name, data] : snapshot.uniforms) {
+        auto bufferItr = std::ranges::find_if(m_buffers,
+                [&name] (const std::shared_ptr<Buffer>& buffer) {
+                    return buffer->name == name;
+                });
+
+        if (bufferItr == m_buffers.end() || data.size() > (*bufferItr)->size) {
+            DEBUG_PRINT("Snapshot uniform " + name + " has no buffer it fits in, skipped");
+            continue;
+        }
+
+        StageBufferWrite(**bufferItr, data);
+    }
+}
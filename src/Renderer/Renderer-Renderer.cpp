@@ -1,120 +1,19 @@
 #include "pch.hpp"
 #include "Renderer/Renderer.hpp"
+
+#include "Utils.hpp"
+#include "Renderer/Pipeline/Pipeline.hpp"
 #include "Renderer/RenderGraph/RenderPass.hpp"
 #include "Renderer/RenderGraph/RenderGraph.hpp"
 #include "Renderer/RenderGraph/ImageResource.hpp"
-
-static void TransitionImageLayout(vk::raii::CommandBuffer& commandBuffer, vk::Image image, [[maybe_unused]] vk::Format format,
-        vk::ImageLayout oldLayout, vk::ImageLayout newLayout, vk::ImageAspectFlags aspect) {
-    vk::ImageMemoryBarrier barrier;
-
-    barrier.setOldLayout(oldLayout)
-            .setNewLayout(newLayout)
-            .setSrcQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
-            .setDstQueueFamilyIndex(VK_QUEUE_FAMILY_IGNORED)
-            .setImage(image)
-            .setSubresourceRange({aspect, 0, 1, 0, 1});
-
-    vk::PipelineStageFlags sourceStage;      // When previous operations must finish
-    vk::PipelineStageFlags destinationStage; // When subsequent operations can start
-
-    // Configure synchronization for undefined-to-transfer layout transitions
-    // This pattern is common when preparing images for data uploads
-    if (oldLayout == vk::ImageLayout::eUndefined && newLayout == vk::ImageLayout::eTransferDstOptimal) {
-        // Configure memory access permissions for upload preparation
-        barrier.setSrcAccessMask(vk::AccessFlagBits::eNone)                // No previous access to synchronize
-               .setDstAccessMask(vk::AccessFlagBits::eTransferWrite);      // Enable transfer write operations
-
-        // Set pipeline stage synchronization points for upload workflow
-        sourceStage = vk::PipelineStageFlagBits::eTopOfPipe;               // No previous work to wait for
-        destinationStage = vk::PipelineStageFlagBits::eTransfer;           // Transfer operations can proceed
-
-    // Configure synchronization for transfer-to-shader layout transitions
-    // This pattern prepares uploaded images for shader sampling
-    } 
-    else if (oldLayout == vk::ImageLayout::eTransferDstOptimal && newLayout == vk::ImageLayout::eShaderReadOnlyOptimal) {
-        // Configure memory access transition from writing to reading
-        barrier.setSrcAccessMask(vk::AccessFlagBits::eTransferWrite)       // Previous transfer writes must complete
-               .setDstAccessMask(vk::AccessFlagBits::eShaderRead);         // Enable shader read access
-
-        // Set pipeline stage synchronization for shader usage workflow
-        sourceStage = vk::PipelineStageFlagBits::eTransfer;                // Transfer operations must complete
-        destinationStage = vk::PipelineStageFlagBits::eFragmentShader;     // Fragment shaders can access
-    }
-    else if (oldLayout == vk::ImageLayout::eColorAttachmentOptimal && newLayout == vk::ImageLayout::eShaderReadOnlyOptimal) {
-        barrier.setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite)
-                .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
-
-        sourceStage = vk::PipelineStageFlagBits::eColorAttachmentOutput;
-        destinationStage = vk::PipelineStageFlagBits::eFragmentShader;
-    }
-    else if (oldLayout == vk::ImageLayout::eDepthAttachmentOptimal && newLayout == vk::ImageLayout::eShaderReadOnlyOptimal) {
-        barrier.setSrcAccessMask(vk::AccessFlagBits::eDepthStencilAttachmentWrite)
-               .setDstAccessMask(vk::AccessFlagBits::eShaderRead);
-
-        sourceStage = vk::PipelineStageFlagBits::eLateFragmentTests;
-        destinationStage = vk::PipelineStageFlagBits::eFragmentShader;
-    }
-    else if (oldLayout == vk::ImageLayout::eUndefined && newLayout == vk::ImageLayout::eColorAttachmentOptimal) {
-        barrier.setSrcAccessMask({})
-               .setDstAccessMask(vk::AccessFlagBits::eColorAttachmentWrite);
-
-        sourceStage = vk::PipelineStageFlagBits::eTopOfPipe;
-        destinationStage = vk::PipelineStageFlagBits::eColorAttachmentOutput;
-    }
-    else if (oldLayout == vk::ImageLayout::eUndefined && newLayout == vk::ImageLayout::eDepthAttachmentOptimal) {
-        barrier.setSrcAccessMask({})
-               .setDstAccessMask(
-                   vk::AccessFlagBits::eDepthStencilAttachmentRead |
-                   vk::AccessFlagBits::eDepthStencilAttachmentWrite
-               );
-
-        sourceStage = vk::PipelineStageFlagBits::eTopOfPipe;
-        destinationStage = vk::PipelineStageFlagBits::eEarlyFragmentTests;
-    }
-    else if (oldLayout == vk::ImageLayout::eColorAttachmentOptimal && newLayout == vk::ImageLayout::ePresentSrcKHR) {
-        barrier.setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite)
-               .setDstAccessMask({}); // Present doesn't need access
-                                      //
-
-        sourceStage = vk::PipelineStageFlagBits::eColorAttachmentOutput;
-        destinationStage = vk::PipelineStageFlagBits::eBottomOfPipe;
-    }
-    else {
-        assert(false && "Unsupported image layout transition");
-    }
-
-    commandBuffer.pipelineBarrier(
-        sourceStage,
-        destinationStage,
-        {},
-        nullptr,
-        nullptr, 
-        barrier);
-}
-
-static void transitionIfNeeded(vk::raii::CommandBuffer& cmd, ImageResource& res, bool isWrite) {
-    vk::ImageLayout newLayout = pickLayout(res, isWrite);
-
-    if (res.initialLayout == newLayout)
-        return;
-
-    TransitionImageLayout(
-        cmd,
-        res.image,
-        res.format,
-        res.initialLayout,
-        newLayout,
-        (res.usage & vk::ImageUsageFlagBits::eDepthStencilAttachment)
-            ? vk::ImageAspectFlagBits::eDepth
-            : vk::ImageAspectFlagBits::eColor
-    );
-
-    res.initialLayout = newLayout;
-}
+#include "Renderer/RenderGraph/BarrierBatch.hpp"
 
 void Renderer::Render() {
-    if (!m_renderGraph) {
+    const bool anyGraph = std::ranges::any_of(m_outputs,
+            [] (const std::unique_ptr<RenderOutput>& output) {
+                return output->renderGraph != nullptr;
+            });
+    if (!anyGraph) {
         throw std::runtime_error("Render Graph not set: call Renderer::SetRenderGraph()");
     }
 
@@ -123,73 +22,352 @@ void Renderer::Render() {
         throw std::runtime_error("Failed to wait for fence");
     }
 
-    auto [result, imageIndex] = m_swapChain.acquireNextImage(UINT64_MAX, *m_presentCompleteSemaphores[frameIndex], nullptr);
+    // Everything recorded for this slot's previous frame is done
+    m_frameCommandPools[frameIndex]->Reset();
+
+    RunRenderCommands();
+
+    bool freshSnapshot = false;
+    m_frameSnapshot = m_snapshots.AcquireLatest(&freshSnapshot);
+    if (freshSnapshot) WriteSnapshotUniforms(*m_frameSnapshot);
+
+    CollectRetiredResources();
+    CollectReadbacks();
+    CheckMemoryBudget();
+    CollectOptimizedPipelines();
+    PublishCompiledPipelines();
+
+    for (std::unique_ptr<RenderOutput>& output : m_outputs) {
+        if (output->dynamicResolution) UpdateDynamicResolution(*output);
+    }
+
+    // Outputs that are minimized or just went out of date sit this frame out
+    std::vector<RenderOutput*> frameOutputs;
+    frameOutputs.reserve(m_outputs.size());
+    for (std::unique_ptr<RenderOutput>& output : m_outputs) {
+        if (output->renderGraph && AcquireOutputImage(*output)) {
+            frameOutputs.push_back(output.get());
+        }
+    }
+    if (frameOutputs.empty()) return;
+
+    m_device.resetFences(*m_framesInFlightFence[frameIndex]);
+
+    const vk::CommandBuffer uploads = RecordUploads();
+
+    for (RenderOutput* output : frameOutputs) {
+        RecordOutput(*output);
+    }
+
+    // Every output goes out in one submit, each waiting only on its own acquire
+    vk::PipelineStageFlags waitDestinationStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput);
+    std::vector<vk::SubmitInfo> submitInfos;
+    submitInfos.reserve(frameOutputs.size() + 1u);
+    if (uploads) {
+        submitInfos.push_back({ .commandBufferCount = 1, .pCommandBuffers = &uploads });
+    }
+    for (RenderOutput* output : frameOutputs) {
+        submitInfos.push_back({
+                .waitSemaphoreCount   = 1,
+                .pWaitSemaphores      = &*output->presentCompleteSemaphores[frameIndex],
+                .pWaitDstStageMask    = &waitDestinationStageMask,
+                .commandBufferCount   = 1,
+                .pCommandBuffers      = &output->commandBuffer,
+                .signalSemaphoreCount = 1,
+                .pSignalSemaphores    = &*output->renderFinishedSemaphores[output->imageIndex]
+            });
+    }
+    m_graphicsQueue.submit(submitInfos, *m_framesInFlightFence[frameIndex]);
+
+    PresentOutputs(frameOutputs);
+
+    frameIndex = (frameIndex + 1u) % MAX_FRAMES_IN_FLIGHT;
+    ++frameCount;
+}
+
+bool Renderer::AcquireOutputImage(RenderOutput& output) {
+    if (output.swapChainOutdated) {
+        reCreateSwapChain(output);
+        if (output.swapChainOutdated) return false; // Still minimized
+    }
+
+    vk::Result result;
+    try {
+        std::tie(result, output.imageIndex) = output.swapChain.acquireNextImage(UINT64_MAX, *output.presentCompleteSemaphores[frameIndex], nullptr);
+    }
+    catch (const vk::OutOfDateKHRError&) {
+        result = vk::Result::eErrorOutOfDateKHR;
+    }
 	if (result == vk::Result::eErrorOutOfDateKHR) {
-		reCreateSwapChain();
-		return;
+		reCreateSwapChain(output);
+		return false;
 	}
     if (result != vk::Result::eSuccess && result != vk::Result::eSuboptimalKHR) {
 		assert(result == vk::Result::eTimeout || result == vk::Result::eNotReady);
 		throw std::runtime_error("failed to acquire swap chain image!");
 	}
-    m_renderGraph->BindExternalResource("BackBuffer", m_swapChainImages[imageIndex], m_swapChainImageViews[imageIndex]);
 
-    const RenderGraph::RenderGraph::OrderedNodes& nodes = m_renderGraph->getOrderedNodes()->get();
+    return true;
+}
 
-    vk::raii::CommandBuffer& buffer = m_commandBuffers[frameIndex];
+void Renderer::RecordOutput(RenderOutput& output) {
+    RenderGraph::RenderGraph& renderGraph = *output.renderGraph;
+    if (renderGraph.isDirty()) {
+        UpdateRenderGraph(renderGraph);
+    }
 
-    m_device.resetFences(*m_framesInFlightFence[frameIndex]);
-    buffer.reset();
-    buffer.begin({});
+    renderGraph.BindExternalResource("BackBuffer", output.swapChainImages[output.imageIndex], output.swapChainImageViews[output.imageIndex]);
+
+    static const RenderGraph::RenderGraph::ExecutionOrder noNodes;
+    auto orderedNodes = renderGraph.getOrderedNodes();
+    const RenderGraph::RenderGraph::ExecutionOrder& nodes = orderedNodes ? orderedNodes->get() : noNodes;
+
+    // With several passes to record, each goes to a secondary recorded by a job. A single one is
+    // cheaper to record inline.
+    const size_t recordedPasses = std::ranges::count_if(nodes, isRecordedByJob);
+    std::vector<vk::CommandBuffer> passCommands;
+    if (recordedPasses > 1u) {
+        passCommands = RecordPassesInParallel(nodes);
+    }
+
+    const vk::raii::CommandBuffer& buffer = m_frameCommandPools[frameIndex]->AllocatePrimary();
+    output.commandBuffer = *buffer;
+
+    buffer.begin({ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit });
+    m_dynamicStateCache.Invalidate();
+
+    const uint32_t firstTimestamp = frameIndex * 2u;
+    if (output.dynamicResolution) {
+        buffer.resetQueryPool(*output.timestampPool, firstTimestamp, 2u);
+        buffer.writeTimestamp2(vk::PipelineStageFlagBits2::eTopOfPipe, *output.timestampPool, firstTimestamp);
+    }
         
-    for (const std::unique_ptr<RenderGraph::RenderPass>& node : nodes) {
-        for (auto& [name, img] : node->readImages) {
-            transitionIfNeeded(buffer, *img, false);
+    RenderGraph::BarrierBatch barriers;
+    for (size_t i = 0u; i < nodes.size(); ++i) {
+        RenderGraph::RenderPass* node = nodes[i];
+        for (const RenderGraph::PlannedTransition& transition : node->transitions) {
+            barriers.Transition(*transition.resource, transition.range, transition.layout);
         }
-        
-        for (auto& [name, img] : node->writeImages) {
-            transitionIfNeeded(buffer, *img, true);
+        for (const RenderGraph::PlannedBufferAccess& access : node->bufferAccesses) {
+            barriers.Access(*access.resource, access.sync, access.write);
+        }
+        barriers.Flush(buffer);
+
+        if (node->recordOnce) {
+            ExecuteStaticPass(*node, buffer, output.imageIndex);
+            continue;
+        }
+
+        if (!passCommands.empty() && isRecordedByJob(node)) {
+            if (!passCommands[i]) {
+                throw std::runtime_error("Failed to record render pass " + node->name);
+            }
+
+            buffer.executeCommands(passCommands[i]);
+            m_dynamicStateCache.Invalidate();
+            continue;
         }
 
         node->BeginPass(buffer);
         node->RunPass(buffer);
         node->EndPass(buffer);
-
     }
     
-    // Submits to present command buffer
-    TransitionImageLayout(buffer, m_swapChainImages[imageIndex], m_SwapChainSurfaceFormat.format, vk::ImageLayout::eColorAttachmentOptimal, vk::ImageLayout::ePresentSrcKHR, vk::ImageAspectFlagBits::eColor);
+    RecordReadbacks(output, buffer, barriers);
+
+    // Submits to present command buffer, BackBuffer may be untouched if its writers are disabled
+    barriers.Transition(renderGraph.getResourceUnsafe("BackBuffer"), vk::ImageLayout::ePresentSrcKHR);
+    barriers.Flush(buffer);
+
+    if (output.dynamicResolution) {
+        buffer.writeTimestamp2(vk::PipelineStageFlagBits2::eBottomOfPipe, *output.timestampPool, firstTimestamp + 1u);
+        output.timestampsWritten[frameIndex] = true;
+    }
 
     buffer.end();
-    
-    vk::PipelineStageFlags waitDestinationStageMask(vk::PipelineStageFlagBits::eColorAttachmentOutput);
-	const vk::SubmitInfo submitInfo{
-        .waitSemaphoreCount   = 1,
-	    .pWaitSemaphores      = &*m_presentCompleteSemaphores[frameIndex], 
-        .pWaitDstStageMask    = &waitDestinationStageMask, 
-        .commandBufferCount   = 1,
-        .pCommandBuffers      = &*m_commandBuffers[frameIndex], 
-        .signalSemaphoreCount = 1,
-        .pSignalSemaphores    = &*m_renderFinishedSemaphores[imageIndex]
+}
+
+// Jobs record ahead of the primary's barriers: passes that transition resources themselves need
+// the graph's tracking as it is at their turn, static ones are recorded from m_commandPool by this
+// thread only
+bool Renderer::isRecordedByJob(const RenderGraph::RenderPass* node) {
+    return !node->recordOnce && !node->midPassBarriers;
+}
+
+// One job per pass isRecordedByJob(), into a secondary from the recording thread's pool of this
+// frame. Other passes are left null. A pass that fails to record has its exception rethrown here,
+// by Wait(). Barriers stay in the primary, between the executeCommands.
+std::vector<vk::CommandBuffer> Renderer::RecordPassesInParallel(std::span<RenderGraph::RenderPass* const> nodes) {
+    std::vector<vk::CommandBuffer> passCommands(nodes.size());
+    JobCounter counter;
+    FrameCommandPools& framePools = *m_frameCommandPools[frameIndex];
+
+    for (size_t i = 0u; i < nodes.size(); ++i) {
+        RenderGraph::RenderPass* node = nodes[i];
+        if (!isRecordedByJob(node)) continue;
+
+        m_jobs.Submit(
+                [this, node, &framePools, &commands = passCommands[i]] () {
+                    const vk::raii::CommandBuffer& secondary = framePools.AllocateSecondary();
+
+                    vk::CommandBufferInheritanceInfo inheritance {};
+                    secondary.begin({ .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit, .pInheritanceInfo = &inheritance });
+                    m_dynamicStateCache.Invalidate();
+
+                    node->BeginPass(secondary);
+                    node->RunPass(secondary);
+                    node->EndPass(secondary);
+
+                    secondary.end();
+                    commands = *secondary;
+                }, &counter);
+    }
+
+    // This thread records passes too while waiting
+    m_jobs.Wait(counter);
+
+    return passCommands;
+}
+
+// The whole pass, rendering begin/end included, lives in the secondary: no inheritance needed.
+// Recordings are kept per swapchain image too, BackBuffer's view is part of the key and would
+// otherwise change nearly every frame.
+void Renderer::ExecuteStaticPass(RenderGraph::RenderPass& pass, const vk::raii::CommandBuffer& primary, uint32_t imageIndex) {
+    assert(!pass.midPassBarriers && "Static passes are replayed without running their mid-pass barriers");
+
+    // Only grows: a buffer stays with the same frame slot whatever the swapchain's image count
+    const size_t slot = static_cast<size_t>(imageIndex) * MAX_FRAMES_IN_FLIGHT + frameIndex;
+    if (pass.recordedCommands.size() <= slot) {
+        vk::CommandBufferAllocateInfo bufferInfo {
+            .commandPool = m_commandPool,
+            .level = vk::CommandBufferLevel::eSecondary,
+            .commandBufferCount = static_cast<uint32_t>((imageIndex + 1u) * MAX_FRAMES_IN_FLIGHT - pass.recordedCommands.size())
+        };
+
+        for (vk::raii::CommandBuffer& secondary : vk::raii::CommandBuffers(m_device, bufferInfo)) {
+            pass.recordedCommands.push_back({ .buffer = std::move(secondary) });
+        }
+    }
+
+    // Last executed by this frame slot's previous submit, whose fence has signaled
+    RenderGraph::RenderPass::RecordedCommands& recorded = pass.recordedCommands[slot];
+
+    const size_t key = getRecordingKey(pass);
+    if (!recorded.recorded || recorded.key != key) {
+        const vk::raii::CommandBuffer& secondary = recorded.buffer;
+
+        vk::CommandBufferInheritanceInfo inheritance {};
+        secondary.begin({ .pInheritanceInfo = &inheritance });
+        m_dynamicStateCache.Invalidate();
+
+        pass.BeginPass(secondary);
+        pass.RunPass(secondary);
+        pass.EndPass(secondary);
+
+        secondary.end();
+
+        recorded.key = key;
+        recorded.recorded = true;
+    }
+
+    primary.executeCommands(*recorded.buffer);
+
+    // State set by the secondary is undefined in the primary afterwards
+    m_dynamicStateCache.Invalidate();
+}
+
+// Everything a static pass's recording refers to. Maps have no stable order, entries are combined commutatively.
+size_t Renderer::getRecordingKey(const RenderGraph::RenderPass& pass) const {
+    size_t seed = 0u;
+    hashCombine(seed, pass.version);
+
+    size_t images = 0u;
+    auto hashImage = [&images] (const ImageResource* image) {
+        size_t imageSeed = 0u;
+        hashCombine(imageSeed, static_cast<VkImage>(image->image));
+        hashCombine(imageSeed, static_cast<VkImageView>(image->view));
+        hashCombine(imageSeed, image->getRenderExtent().width);
+        hashCombine(imageSeed, image->getRenderExtent().height);
+        if (image->resolveImage) {
+            hashCombine(imageSeed, static_cast<VkImageView>(image->resolveImage->view));
+        }
+        images += imageSeed;
     };
-    m_graphicsQueue.submit(submitInfo, *m_framesInFlightFence[frameIndex]);
-    
+    for (const auto& [name, image] : pass.readImages) hashImage(image);
+    for (const auto& [name, image] : pass.writeImages) hashImage(image);
+    hashCombine(seed, images);
+
+    size_t buffers = 0u;
+    for (const auto& [name, buffer] : pass.readBuffers) buffers += std::hash<VkBuffer>{}(static_cast<VkBuffer>(buffer->buffer));
+    for (const auto& [name, buffer] : pass.writeBuffers) buffers += std::hash<VkBuffer>{}(static_cast<VkBuffer>(buffer->buffer));
+    for (const auto& [name, buffer] : pass.buffers) buffers += std::hash<VkBuffer>{}(buffer->getHandle());
+    hashCombine(seed, buffers);
+
+    // What Bind() binds: changes when an async pipeline becomes ready or an optimized link is swapped in
+    size_t pipelines = 0u;
+    for (const auto& [name, pipeline] : pass.pipelines) {
+        const Pipeline* bound = pipeline.get();
+        while (bound && !bound->handle) {
+            bound = bound->fallback.get();
+        }
+        if (!bound) continue;
+
+        const PipelineHandle& handle = *bound->handle;
+        pipelines += handle.isShaderObject()
+            ? std::hash<VkShaderEXT>{}(static_cast<VkShaderEXT>(handle.shaderHandles.front()))
+            : std::hash<VkPipeline>{}(static_cast<VkPipeline>(*handle.pipeline));
+    }
+    hashCombine(seed, pipelines);
+
+    return seed;
+}
+
+void Renderer::PresentOutputs(std::span<RenderOutput* const> outputs) {
+    std::vector<vk::Semaphore> waitSemaphores;
+    std::vector<vk::SwapchainKHR> swapChains;
+    std::vector<uint32_t> imageIndices;
+    for (const RenderOutput* output : outputs) {
+        waitSemaphores.push_back(*output->renderFinishedSemaphores[output->imageIndex]);
+        swapChains.push_back(*output->swapChain);
+        imageIndices.push_back(output->imageIndex);
+    }
+
+    // One present for every swapchain, per-swapchain results tell which ones need recreating
+    std::vector<vk::Result> results(outputs.size(), vk::Result::eSuccess);
     vk::PresentInfoKHR presentInfoKHR {
-        .waitSemaphoreCount = 1,
-        .pWaitSemaphores    = &*m_renderFinishedSemaphores[imageIndex],
-        .swapchainCount     = 1,
-        .pSwapchains        = &*m_swapChain,
-        .pImageIndices      = &imageIndex
+        .waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size()),
+        .pWaitSemaphores    = waitSemaphores.data(),
+        .swapchainCount     = static_cast<uint32_t>(swapChains.size()),
+        .pSwapchains        = swapChains.data(),
+        .pImageIndices      = imageIndices.data(),
+        .pResults           = results.data()
     };
-    result = m_presentQueue.presentKHR(presentInfoKHR);
 
-    if ((result == vk::Result::eSuboptimalKHR) || (result == vk::Result::eErrorOutOfDateKHR) || m_frameBufferResized) {
-        m_frameBufferResized = false;
-    	reCreateSwapChain();
+    bool outOfDate = false;
+    try {
+        [[maybe_unused]] vk::Result result = m_presentQueue.presentKHR(presentInfoKHR);
     }
-    else {
-    	assert(result == vk::Result::eSuccess);
+    catch (const vk::OutOfDateKHRError&) {
+        outOfDate = true;
     }
 
-    frameIndex = (frameIndex + 1u) % MAX_FRAMES_IN_FLIGHT;
+    // Without a per-swapchain error to blame, every output is recreated
+    const bool blameAll = outOfDate && std::ranges::all_of(results,
+            [] (vk::Result result) { return result == vk::Result::eSuccess; });
+
+    for (size_t i = 0u; i < outputs.size(); ++i) {
+        RenderOutput& output = *outputs[i];
+        const vk::Result result = results[i];
+
+        if (result == vk::Result::eSuccess || result == vk::Result::eSuboptimalKHR) {
+            MarkPresented(output);
+        }
+
+        if (blameAll || result == vk::Result::eSuboptimalKHR || result == vk::Result::eErrorOutOfDateKHR || output.frameBufferResized) {
+            reCreateSwapChain(output);
+        }
+        else {
+            assert(result == vk::Result::eSuccess);
+        }
+    }
 }
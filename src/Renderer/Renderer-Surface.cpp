@@ -2,11 +2,11 @@
 #include "Renderer/Renderer.hpp"
 #include "Renderer/Renderer-Exceptions.hpp"
 
-void Renderer::CreateSurface() {
+void Renderer::CreateSurface(RenderOutput& output) {
     VkSurfaceKHR _surface;
-    if (glfwCreateWindowSurface(*m_instance, m_window, nullptr, &_surface) != 0) {
+    if (glfwCreateWindowSurface(*m_instance, output.window, nullptr, &_surface) != 0) {
         throw CreateSurface_Error("Failed to create vkSurface");
     }
 
-    m_surface = vk::raii::SurfaceKHR(m_instance, _surface);
+    output.surface = vk::raii::SurfaceKHR(m_instance, _surface);
 }
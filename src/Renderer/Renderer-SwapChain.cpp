@@ -3,25 +3,30 @@
 #include "Renderer/RenderGraph/RenderGraph.hpp"
 #include "Renderer/Renderer-Exceptions.hpp"
 
-static vk::Extent2D ChooseSwapChainExtent(GLFWwindow* const window, const vk::SurfaceCapabilitiesKHR& surfaceCapabilities) {
+static vk::Extent2D ChooseSwapChainExtent(vk::Extent2D frameBufferSize, const vk::SurfaceCapabilitiesKHR& surfaceCapabilities) {
     if (surfaceCapabilities.currentExtent.width != std::numeric_limits<uint32_t>::max()) {
         return surfaceCapabilities.currentExtent;
     }
 
-    int width, height;
-    glfwGetFramebufferSize(window, &width, &height);
-
     return {
-        std::clamp<uint32_t>(width, surfaceCapabilities.minImageExtent.width, surfaceCapabilities.maxImageExtent.width),
-        std::clamp<uint32_t>(height, surfaceCapabilities.minImageExtent.height, surfaceCapabilities.maxImageExtent.height)
+        std::clamp<uint32_t>(frameBufferSize.width, surfaceCapabilities.minImageExtent.width, surfaceCapabilities.maxImageExtent.width),
+        std::clamp<uint32_t>(frameBufferSize.height, surfaceCapabilities.minImageExtent.height, surfaceCapabilities.maxImageExtent.height)
     };
 }
 
-static vk::SurfaceFormatKHR ChooseSwapChainFormat(const std::vector<vk::SurfaceFormatKHR>& availableFormats) {
+static vk::SurfaceFormatKHR ChooseSwapChainFormat(const std::vector<vk::SurfaceFormatKHR>& availableFormats, std::optional<vk::Format> requiredFormat) {
     if (availableFormats.empty()) {
         throw CreateSwapChain_Error("No available formats");
     }
 
+    if (requiredFormat) {
+        const auto requiredItr = std::ranges::find(availableFormats, requiredFormat.value(), &vk::SurfaceFormatKHR::format);
+        if (requiredItr == availableFormats.end()) {
+            throw CreateSwapChain_Error("Surface does not support the primary output format");
+        }
+        return *requiredItr;
+    }
+
     const auto formatItr = std::ranges::find_if(availableFormats,
             [] (const vk::SurfaceFormatKHR& format) -> bool {
                 return format.format == vk::Format::eB8G8R8A8Srgb && format.colorSpace == vk::ColorSpaceKHR::eSrgbNonlinear;
@@ -48,71 +53,127 @@ static uint32_t choooseMinSwapChainImageCount(const vk::SurfaceCapabilitiesKHR&
     return minImageCount;
 }
 
-void Renderer::CreateSwapChain() {
-    vk::SurfaceCapabilitiesKHR surfaceCapabilities = m_physicalDevice.getSurfaceCapabilitiesKHR(*m_surface);
+void Renderer::CreateSwapChain(RenderOutput& output, vk::SwapchainKHR oldSwapChain) {
+    vk::SurfaceCapabilitiesKHR surfaceCapabilities = m_physicalDevice.getSurfaceCapabilitiesKHR(*output.surface);
 
-    vk::Extent2D extent = ChooseSwapChainExtent(m_window, surfaceCapabilities);
-    vk::SurfaceFormatKHR format = ChooseSwapChainFormat(m_physicalDevice.getSurfaceFormatsKHR(*m_surface));
-    vk::PresentModeKHR presentMode = ChooseSwapChainPresentMode(m_physicalDevice.getSurfacePresentModesKHR(*m_surface));
+    // Every output renders with the pipelines built for the primary swapchain format
+    std::optional<vk::Format> requiredFormat;
+    if (&output != &getPrimaryOutput() || oldSwapChain) requiredFormat = getPrimaryOutput().surfaceFormat.format;
+
+    vk::Extent2D extent = ChooseSwapChainExtent(output.frameBufferSize, surfaceCapabilities);
+    vk::SurfaceFormatKHR format = ChooseSwapChainFormat(m_physicalDevice.getSurfaceFormatsKHR(*output.surface), requiredFormat);
+    vk::PresentModeKHR presentMode = ChooseSwapChainPresentMode(m_physicalDevice.getSurfacePresentModesKHR(*output.surface));
+
+    // Transfer destination lets a final blit (UpscalePass) write the swapchain image, transfer
+    // source lets it be read back
+    vk::ImageUsageFlags usage = vk::ImageUsageFlagBits::eColorAttachment;
+    if (surfaceCapabilities.supportedUsageFlags & vk::ImageUsageFlagBits::eTransferDst) {
+        usage |= vk::ImageUsageFlagBits::eTransferDst;
+    }
+    if (surfaceCapabilities.supportedUsageFlags & vk::ImageUsageFlagBits::eTransferSrc) {
+        usage |= vk::ImageUsageFlagBits::eTransferSrc;
+    }
 
     vk::SwapchainCreateInfoKHR swapChainCreateInfo {
-        .surface = *m_surface,
+        .surface = *output.surface,
         .minImageCount = choooseMinSwapChainImageCount(surfaceCapabilities),
         .imageFormat = format.format,
         .imageColorSpace = format.colorSpace,
         .imageExtent = extent,
         .imageArrayLayers = 1,
-        .imageUsage = vk::ImageUsageFlagBits::eColorAttachment,
+        .imageUsage = usage,
         .imageSharingMode = vk::SharingMode::eExclusive,
         .preTransform = surfaceCapabilities.currentTransform,
         .compositeAlpha = vk::CompositeAlphaFlagBitsKHR::eOpaque,
         .presentMode = presentMode,
         .clipped = true,
-        .oldSwapchain = nullptr
+        .oldSwapchain = oldSwapChain
     };
 
-    m_swapChainExtent = extent;
-    m_SwapChainSurfaceFormat = format;
+    output.swapChainExtent = extent;
+    output.surfaceFormat = format;
+    if (&output == &getPrimaryOutput()) m_swapChainFormat = format.format;
+    output.swapChainUsage = usage;
 
-    m_swapChain = vk::raii::SwapchainKHR(m_device, swapChainCreateInfo);
+    output.swapChain = vk::raii::SwapchainKHR(m_device, swapChainCreateInfo);
 
-    m_swapChainImages.clear();
-    m_swapChainImageViews.clear();
+    output.swapChainImages.clear();
+    output.swapChainImageViews.clear();
 
-    m_swapChainImages = m_swapChain.getImages();
-    m_swapChainImageViews.reserve(m_swapChainImages.size());
+    output.swapChainImages = output.swapChain.getImages();
+    output.swapChainImageViews.reserve(output.swapChainImages.size());
    
     vk::ImageViewCreateInfo imageViewCreateInfo {
         .viewType = vk::ImageViewType::e2D,
         .format = format.format,
         .subresourceRange = { vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1 }
     };
-    for (const vk::Image& image : m_swapChainImages) {
+    for (const vk::Image& image : output.swapChainImages) {
         imageViewCreateInfo.image = image;
-        m_swapChainImageViews.emplace_back(m_device, imageViewCreateInfo);
+        output.swapChainImageViews.emplace_back(m_device, imageViewCreateInfo);
     };
+
+    // One per image: a semaphore may still be pending on a previous present of the same image
+    output.renderFinishedSemaphores.clear();
+    output.renderFinishedSemaphores.reserve(output.swapChainImages.size());
+    for (size_t i = 0; i < output.swapChainImages.size(); i++) {
+        output.renderFinishedSemaphores.emplace_back(m_device, vk::SemaphoreCreateInfo());
+    }
 }
 
-void Renderer::reCreateSwapChain() {
-	int width = 0, height = 0;
-	glfwGetFramebufferSize(m_window, &width, &height);
-	while (width == 0 || height == 0)
-	{
-		glfwGetFramebufferSize(m_window, &width, &height);
-		glfwWaitEvents();
+void Renderer::reCreateSwapChain(RenderOutput& output) {
+	const vk::Extent2D frameBufferSize = output.frameBufferSize;
+	if (frameBufferSize.width == 0 || frameBufferSize.height == 0) {
+        // Minimized: retry on the next Render() once the window has a size again
+        output.swapChainOutdated = true;
+        return;
 	}
+    output.swapChainOutdated = false;
+    output.frameBufferResized = false;
 
-	m_device.waitIdle();
+    // The old swapchain is handed to the new one and destroyed once its presents are done, see MarkPresented()
+    RenderOutput::RetiredSwapChain& retired = output.retiredSwapChains.emplace_back(RenderOutput::RetiredSwapChain {
+            .swapChain = std::move(output.swapChain),
+            .imageViews = std::move(output.swapChainImageViews),
+            .renderFinishedSemaphores = std::move(output.renderFinishedSemaphores)
+        });
 
-	CleanupSwapChain();
-	CreateSwapChain();
+	CreateSwapChain(output, *retired.swapChain);
 
-    ImageResource& backBuffer = m_renderGraph->getResourceUnsafe("BackBuffer");
-    backBuffer.format = m_SwapChainSurfaceFormat.format;
-    backBuffer.extent = m_swapChainExtent;
+    // Swapchains retired earlier wait for this one's presents too
+    output.imagesPresented.assign(output.swapChainImages.size(), false);
+
+    if (!output.renderGraph) return;
+
+    ImageResource& backBuffer = output.renderGraph->getResourceUnsafe("BackBuffer");
+    backBuffer.format = output.surfaceFormat.format;
+    backBuffer.extent = output.swapChainExtent;
+    backBuffer.usage = output.swapChainUsage;
+
+    // Swapchain-relative images follow, the others keep their memory
+    if (!output.renderGraph->UpdateExtents().empty()) {
+        AllocateGraphImages(*output.renderGraph);
+    }
+}
+
+// A present of `output`'s current image was queued
+void Renderer::MarkPresented(RenderOutput& output) {
+    if (output.retiredSwapChains.empty()) return;
+
+    output.imagesPresented[output.imageIndex] = true;
+    if (!std::ranges::all_of(output.imagesPresented, std::identity{})) return;
+
+    // Still behind this frame's fence like any other resource
+    m_deletionQueue.Push(frameCount,
+            [retired = std::move(output.retiredSwapChains)] () mutable {
+                retired.clear();
+            });
+    output.retiredSwapChains.clear();
 }
 
-void Renderer::CleanupSwapChain() {
-	m_swapChainImageViews.clear();
-	m_swapChain = nullptr;
+void Renderer::CleanupSwapChain(RenderOutput& output) {
+	output.retiredSwapChains.clear();
+	output.swapChainImageViews.clear();
+	output.renderFinishedSemaphores.clear();
+	output.swapChain = nullptr;
 }
@@ -1,6 +1,7 @@
 #include "pch.hpp"
 #include "Renderer/Renderer.hpp"
 #include "Renderer/Renderer-Exceptions.hpp"
+#include "Renderer/RenderGraph/RenderGraph.hpp"
 #include <vma/vk_mem_alloc.h>
 #include "Utils.hpp"
 
@@ -11,34 +12,47 @@ namespace InitialValues {
     };
 }
 
-void Renderer::InitGLFW(const std::string& title) {
+void Renderer::InitGLFW() {
     glfwInit();
 
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+}
+
+RenderOutput& Renderer::CreateOutputWindow(const std::string& title, vk::Extent2D size) {
+    RenderOutput& output = *m_outputs.emplace_back(std::make_unique<RenderOutput>());
+
+    output.window = glfwCreateWindow(size.width, size.height, title.c_str(), nullptr, nullptr);
 
-    m_window = glfwCreateWindow(InitialValues::windowSize.width, InitialValues::windowSize.height, title.c_str(), nullptr, nullptr);
+    glfwSetWindowUserPointer(output.window, &output);
+    glfwSetFramebufferSizeCallback(output.window, FrameBufferSizeCallback);
 
-    glfwSetWindowUserPointer(m_window, this);
-    glfwSetFramebufferSizeCallback(m_window, FrameBufferSizeCallback);
+    int width = 0, height = 0;
+    glfwGetFramebufferSize(output.window, &width, &height);
+    output.frameBufferSize = vk::Extent2D{ static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
+
+    return output;
 }
 
-void Renderer::FrameBufferSizeCallback(GLFWwindow *window, int, int) {
-    Renderer* renderer = static_cast<Renderer*>(glfwGetWindowUserPointer(window));
-    renderer->m_frameBufferResized = true; 
+// The swapchain code reads the size from the output: glfwGetFramebufferSize is main thread only
+void Renderer::FrameBufferSizeCallback(GLFWwindow *window, int width, int height) {
+    RenderOutput* output = static_cast<RenderOutput*>(glfwGetWindowUserPointer(window));
+    output->frameBufferSize = vk::Extent2D{ static_cast<uint32_t>(width), static_cast<uint32_t>(height) };
+    output->frameBufferResized = true; 
 }
 
 Renderer::InitResult Renderer::Init(const std::string& title) {
-    InitGLFW(title);
+    InitGLFW();
+    RenderOutput& primaryOutput = CreateOutputWindow(title, InitialValues::windowSize);
 
     try {
         CreateInstance(title);
-        CreateSurface();
+        CreateSurface(primaryOutput);
         PickPhysicalDevice();
         CreateLogicalDeviceAndQueues();
-        CreateSwapChain();
-        CreateCommandPool();
-        CreateCommandBuffers();
+        CreateSwapChain(primaryOutput);
+        CreateCommandPools();
         CreateSyncObjects();
+        CreateOutputSyncObjects(primaryOutput);
         CreateAllocator();
     }
     catch (const CreateInstance_Error& e) {
@@ -65,28 +79,115 @@ Renderer::InitResult Renderer::Init(const std::string& title) {
     return InitResult::OK;
 }
 
+std::expected<Renderer::OutputId, Renderer::AddOutputError> Renderer::AddOutput(const std::string& title, vk::Extent2D size) {
+    RenderOutput& output = CreateOutputWindow(title, size);
+    const OutputId id = static_cast<OutputId>(m_outputs.size() - 1u);
+
+    // The surface has to go before its window
+    auto discard = [this, window = output.window] {
+        m_outputs.pop_back();
+        glfwDestroyWindow(window);
+    };
+
+    try {
+        CreateSurface(output);
+    }
+    catch (const CreateSurface_Error& e) {
+        DEBUG_PRINT(e.what());
+        discard();
+        return std::unexpected(AddOutputError::SURFACE_FAILED);
+    }
+
+    // The queues were picked for the primary surface
+    if (!m_physicalDevice.getSurfaceSupportKHR(m_presentFamilyIndex, *output.surface)) {
+        discard();
+        return std::unexpected(AddOutputError::PRESENT_UNSUPPORTED);
+    }
+
+    try {
+        CreateSwapChain(output);
+    }
+    catch (const CreateSwapChain_Error& e) {
+        DEBUG_PRINT(e.what());
+        discard();
+        return std::unexpected(AddOutputError::SWAPCHAIN_FAILED);
+    }
+
+    CreateOutputSyncObjects(output);
+
+    return id;
+}
+
 void Renderer::Update() {
-    glfwPollEvents();
+    // Block instead of spinning while every output is minimized, a resize event wakes us up
+    const bool allOutdated = std::ranges::all_of(m_outputs,
+            [] (const std::unique_ptr<RenderOutput>& output) {
+                return output->swapChainOutdated;
+            });
+
+    if (allOutdated) glfwWaitEvents();
+    else glfwPollEvents();
+
+    // GLFW calls requested by other threads
+    m_jobs.PumpMainThread();
 }
 
 void Renderer::Shutdown() {
+    // Errors of the render thread are only reported by StopRenderThread()
+    if (m_renderThread.joinable()) {
+        m_renderThread.request_stop();
+        m_renderThread.join();
+    }
+
     m_device.waitIdle();
 
+    // Compiles and optimized links use the device, readback callbacks the ring's buffers
+    WaitForBackgroundJobs();
+
+    for (const std::unique_ptr<ReadbackSlot>& slot : m_readbackSlots) {
+        DestroyReadbackBuffer(*slot);
+    }
+    m_readbackSlots.clear();
+
+    m_deletionQueue.FlushAll();
+
+    // Written but never submitted
+    for (const PendingUpload& upload : m_pendingUploads) {
+        m_memoryTracker.Untrack(m_allocator, upload.stagingAllocation);
+        vmaDestroyBuffer(m_allocator, upload.staging, upload.stagingAllocation);
+    }
+    m_pendingUploads.clear();
+
     for (const std::shared_ptr<Buffer>& buffer : m_buffers) {
+        m_memoryTracker.Untrack(m_allocator, buffer->allocation);
         vmaDestroyBuffer(m_allocator, buffer->buffer, buffer->allocation);
     }
 
+    for (std::unique_ptr<RenderOutput>& output : m_outputs) {
+        if (!output->renderGraph) continue;
+
+        DestroyGraphImages(*output->renderGraph);
+        DestroyGraphBuffers(*output->renderGraph);
+    }
+
     if (m_allocator) {
         vmaDestroyAllocator(m_allocator);
     }
 
-    CleanupSwapChain();
-
-    glfwDestroyWindow(m_window);
+    for (std::unique_ptr<RenderOutput>& output : m_outputs) {
+        CleanupSwapChain(*output);
+        glfwDestroyWindow(output->window);
+    }
 
     glfwTerminate();
 }
 
+// Closing any window, or the render thread failing, stops the application
 bool Renderer::isRunning() const {
-    return !glfwWindowShouldClose(m_window);
+    if (m_renderThreadFailed) return false;
+
+    return std::ranges::none_of(m_outputs,
+            [] (const std::unique_ptr<RenderOutput>& output) {
+                return glfwWindowShouldClose(output->window);
+            });
 }
@@ -29,6 +29,16 @@ std::expected<ByteArray, ReadFileError> readRawFile(const fs::path& filePath) {
     return rawData;
 }
 
+bool writeRawFile(const fs::path& filePath, std::span<const std::byte> data) {
+    std::ofstream file(filePath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(file);
+}
+
 ByteArray readRawFileFast(const fs::path& filePath) {
     std::ifstream file(filePath, std::ios::binary | std::ios::ate);
 
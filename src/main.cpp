@@ -49,13 +49,7 @@ class ForwardPass : public RenderGraph::RenderPass {
 
             vk::ClearValue clearColor = vk::ClearColorValue(1.0f, 0.0f, 0.0f, 1.0f);
 
-		    vk::RenderingAttachmentInfo attachmentInfo = {
-		        .imageView   = backBuffer->view,
-		        .imageLayout = vk::ImageLayout::eColorAttachmentOptimal,
-		        .loadOp      = vk::AttachmentLoadOp::eClear,
-		        .storeOp     = vk::AttachmentStoreOp::eStore,
-		        .clearValue  = clearColor
-            };
+		    vk::RenderingAttachmentInfo attachmentInfo = getAttachmentInfo("BackBuffer", vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eStore, clearColor);
 		    
             vk::RenderingInfo renderingInfo = {
 		        .renderArea           = {.offset = {0, 0}, .extent = backBuffer->extent},
@@ -65,15 +59,21 @@ class ForwardPass : public RenderGraph::RenderPass {
             };
 
 		    cmd.beginRendering(renderingInfo);
-		    cmd.setScissor(0, vk::Rect2D(vk::Offset2D(0, 0), backBuffer->extent));
         }
 
         void RunPass(const vk::raii::CommandBuffer& cmd) override {
-            pipelines.at("Main")->Bind(cmd);
+            const FrameSnapshot* snapshot = renderer->getFrameSnapshot();
+            if (!snapshot) return;
+
+            for (const DrawItem& draw : snapshot->draws) {
+                const std::shared_ptr<const Pipeline>& pipeline = pipelines.at(draw.pipeline);
+                if (!pipeline->Bind(cmd)) continue;
 
-		    cmd.setViewport(0, 
-                    vk::Viewport(0.0f, 0.0f, static_cast<float>(backBuffer->extent.width), static_cast<float>(backBuffer->extent.height), 0.0f, 1.0f));
-            cmd.draw(3, 1, 0, 0);
+		        pipeline->SetScissor(cmd, vk::Rect2D(vk::Offset2D(0, 0), backBuffer->extent));
+		        pipeline->SetViewport(cmd, 
+                        vk::Viewport(0.0f, 0.0f, static_cast<float>(backBuffer->extent.width), static_cast<float>(backBuffer->extent.height), 0.0f, 1.0f));
+                cmd.draw(draw.vertexCount, draw.instanceCount, draw.firstVertex, draw.firstInstance);
+            }
         }
 
         void EndPass(const vk::raii::CommandBuffer& cmd) override {
@@ -90,15 +90,29 @@ int main() {
 
         renderGraph.AddRenderPass<ForwardPass>();
 
-        renderer.SetRenderGraph(std::make_unique<RenderGraph::RenderGraph>(std::move(renderGraph)));
+        renderer.SetRenderGraph(std::make_unique<RenderGraph::RenderGraph>(std::move(renderGraph)), "renderGraph.bin");
     }
     
+    // The simulation runs here, one snapshot ahead of the render thread
+    renderer.StartRenderThread();
+
+    const auto start = std::chrono::steady_clock::now();
+    uint64_t simulationFrame = 0u;
     while (renderer.isRunning()) {
         renderer.Update();
 
-        renderer.Render();
+        FrameSnapshot& snapshot = renderer.BeginSnapshot();
+        snapshot.simulationFrame = simulationFrame++;
+        snapshot.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        snapshot.camera = {};
+        snapshot.draws = { DrawItem { .pipeline = "Main", .vertexCount = 3u } };
+        snapshot.uniforms.clear();
+        renderer.PublishSnapshot();
+
+        renderer.WaitForSnapshotConsumed(std::chrono::milliseconds(100));
     }
 
+    renderer.StopRenderThread();
     renderer.Shutdown();
 
     return EXIT_SUCCESS;